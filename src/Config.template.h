@@ -65,6 +65,15 @@ constexpr char STATICSCHEME[]   = "https://";
 constexpr char LOCAL_SAVE_DIR[] = "Saves";
 constexpr char STAMPS_DIR[]     = "stamps";
 constexpr char BRUSH_DIR[]      = "Brushes";
+constexpr char LUA_CACHE_DIR[]  = "luacache";
+constexpr char THUMB_CACHE_DIR[] = "thumbcache";
+constexpr char HTTP_CACHE_DIR[] = "httpcache";
 
+constexpr int httpMaxHostConnections   = 1;
 constexpr int httpMaxConcurrentStreams = 50;
+constexpr int httpMaxTransfers         = 16; // handed to curl at once, the rest wait their turn
+constexpr int httpMaxBulkTransfers     = 4; // of those, how many may be thumbnails and such
+constexpr int httpMaxPrefetchTransfers = 2; // and how many may be prefetches
 constexpr int httpConnectTimeoutS      = 15;
+constexpr int httpCacheMaxBytes        = 64 * 1024 * 1024;
+constexpr int thumbCacheMaxBytes       = 16 * 1024 * 1024;
@@ -13,6 +13,7 @@
 #include "graphics/Graphics.h"
 #include "simulation/SaveRenderer.h"
 #include "simulation/SimulationData.h"
+#include "tasks/TaskScheduler.h"
 #include "common/tpt-rand.h"
 #include "gui/game/Favorite.h"
 #include "gui/Style.h"
@@ -234,6 +235,7 @@ struct ExplicitSingletons
 	// These need to be listed in the order they are populated in main.
 	std::unique_ptr<GlobalPrefs> globalPrefs;
 	http::RequestManagerPtr requestManager;
+	std::unique_ptr<TaskScheduler> taskScheduler;
 	std::unique_ptr<Client> client;
 	std::unique_ptr<SaveRenderer> saveRenderer;
 	std::unique_ptr<Favorite> favorite;
@@ -259,6 +261,12 @@ int Main(int argc, char *argv[])
 			signal(msg->sig, SIG_DFL);
 		}
 		SDLClose();
+		// Saves still being written need SimulationData, which goes away before Client does;
+		// the window is already gone, so failures can only be logged
+		if (explicitSingletons && explicitSingletons->client)
+		{
+			Client::Ref().FinishSaveFiles();
+		}
 		explicitSingletons.reset();
 	});
 	explicitSingletons = std::make_unique<ExplicitSingletons>();
@@ -426,6 +434,7 @@ int Main(int argc, char *argv[])
 	bool disableNetwork = true_arg(arguments["disable-network"]);
 	explicitSingletons->requestManager = http::RequestManager::Create(proxyString, cafileString, capathString, disableNetwork);
 
+	explicitSingletons->taskScheduler = std::make_unique<TaskScheduler>();
 	explicitSingletons->client = std::make_unique<Client>();
 	Client::Ref().Initialize();
 
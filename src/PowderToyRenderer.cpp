@@ -1,3 +1,5 @@
+#include "graphics/FrameRecording.h"
+#include "graphics/FrameWriter.h"
 #include "graphics/Graphics.h"
 #include "graphics/Renderer.h"
 #include "common/String.h"
@@ -8,28 +10,58 @@
 #include "simulation/Simulation.h"
 #include "simulation/SimulationData.h"
 #include "common/platform/Platform.h"
+#include "Config.h"
+#include <algorithm>
+#include <atomic>
 #include <ctime>
 #include <iostream>
 #include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
 #include <vector>
 
-int main(int argc, char *argv[])
+namespace
 {
-	if (!argv[1] || !argv[2]) {
-		std::cout << "Usage: " << argv[0] << " <inputFilename> <outputPrefix>" << std::endl;
-		return 1;
-	}
-	auto inputFilename = ByteString(argv[1]);
-	auto outputFilename = ByteString(argv[2]) + ".png";
+	// A Simulation and Renderer pair that can be reused across any number of
+	// saves, see RenderSave.
+	struct RenderContext
+	{
+		std::unique_ptr<Simulation> sim;
+		std::unique_ptr<Renderer> ren;
 
-	auto simulationData = std::make_unique<SimulationData>();
+		RenderContext()
+		{
+			sim = std::make_unique<Simulation>();
+			ren = std::make_unique<Renderer>(sim.get());
+		}
+	};
 
-	std::vector<char> fileData;
-	if (!Platform::ReadFile(fileData, inputFilename))
+	struct RenderOptions
 	{
-		return 1;
-	}
+		int threads = 0;
+		int preset = -1;
+		int frames = 0;
+		int every = 1;
+		FrameWriter::Codec codec = FrameWriter::codecPNG;
+		int keyframeInterval = 300;
+	};
 
+	struct BatchJob
+	{
+		ByteString inputFilename;
+		ByteString outputFilename;
+		bool ok = false;
+		ByteString error;
+		unsigned long time = 0;
+	};
+}
+
+// Throws ParseException if the save is from a newer version, draws an error
+// message in place of the save for any other parse error and returns false.
+static bool LoadSave(RenderContext &ctx, const std::vector<char> &fileData, const RenderOptions &options)
+{
 	std::unique_ptr<GameSave> gameSave;
 	try
 	{
@@ -42,8 +74,19 @@ int main(int argc, char *argv[])
 			throw e;
 	}
 
-	Simulation * sim = new Simulation();
-	Renderer * ren = new Renderer(sim);
+	auto *sim = ctx.sim.get();
+	auto *ren = ctx.ren.get();
+	ren->ResetModes();
+	if (options.preset >= 0 && options.preset < int(ren->renderModePresets.size()))
+	{
+		auto &preset = ren->renderModePresets[options.preset];
+		ren->SetRenderMode(preset.RenderModes);
+		ren->SetDisplayMode(preset.DisplayModes);
+		ren->SetColourMode(preset.ColourMode);
+	}
+	sim->clear_sim();
+	ren->ClearAccumulation();
+	ren->clearScreen();
 
 	if (gameSave)
 	{
@@ -61,6 +104,7 @@ int main(int argc, char *argv[])
 			ren->render_fire();
 			ren->clearScreen();
 		}
+		return true;
 	}
 	else
 	{
@@ -68,11 +112,331 @@ int main(int argc, char *argv[])
 		int w = Graphics::TextSize("Save file invalid").X + 15, x = (XRES-w)/2, y = (YRES-24)/2;
 		ren->DrawRect(RectSized(Vec2{ x, y }, Vec2{ w, 24 }), 0xC0C0C0_rgb);
 		ren->BlendText({ x+8, y+8 }, "Save file invalid", 0xC0C0F0_rgb .WithAlpha(255));
+		return false;
+	}
+}
+
+static void RenderFrame(RenderContext &ctx)
+{
+	ctx.ren->draw_air();
+	ctx.ren->RenderBegin();
+	ctx.ren->RenderEnd();
+}
+
+static std::unique_ptr<std::vector<char>> RenderPNG(RenderContext &ctx)
+{
+	RenderFrame(ctx);
+	return ctx.ren->DumpFrame().ToPNG();
+}
+
+static std::unique_ptr<std::vector<char>> RenderSave(RenderContext &ctx, const std::vector<char> &fileData, const RenderOptions &options)
+{
+	LoadSave(ctx, fileData, options);
+	return RenderPNG(ctx);
+}
+
+static int RenderAnimation(ByteString inputFilename, ByteString outputPrefix, const RenderOptions &options)
+{
+	std::vector<char> fileData;
+	if (!Platform::ReadFile(fileData, inputFilename))
+	{
+		return 1;
+	}
+	RenderContext ctx;
+	if (!LoadSave(ctx, fileData, options))
+	{
+		std::cerr << inputFilename << ": save file invalid" << std::endl;
+		return 1;
+	}
+
+	// Encoding happens on the writer's thread; simulating only waits for it
+	// if it falls a whole queue behind.
+	auto start = Platform::GetTime();
+	{
+		FrameWriter writer(outputPrefix, options.codec, 32, options.keyframeInterval);
+		for (int frame = 0; frame < options.frames; frame++)
+		{
+			if (frame % options.every == 0)
+			{
+				ctx.ren->clearScreen();
+				RenderFrame(ctx);
+				writer.Push(ctx.ren->DumpFrame());
+			}
+			ctx.sim->UpdateUpTo(NPART);
+		}
+		auto simulated = Platform::GetTime() - start;
+		writer.Finish();
+		if (auto error = writer.GetError())
+		{
+			std::cerr << *error << std::endl;
+			return 2;
+		}
+		auto stats = writer.GetStats();
+		std::cout << options.frames << " frames simulated in " << simulated << " ms, " << stats.pushed << " written";
+		std::cout << " (" << stats.stalls << " waits for the writer, " << stats.stallMs << " ms)" << std::endl;
+	}
+	std::cout << "done in " << Platform::GetTime() - start << " ms" << std::endl;
+	return 0;
+}
+
+// Expands a recording back into numbered images
+static int ExtractRecording(ByteString inputFilename, ByteString outputPrefix, const RenderOptions &options)
+{
+	std::ifstream stream(inputFilename, std::ios::binary);
+	if (!stream)
+	{
+		std::cerr << "Cannot open " << inputFilename << std::endl;
+		return 1;
+	}
+	auto codec = options.codec == FrameWriter::codecDelta ? FrameWriter::codecPNG : options.codec;
+	uint64_t frames = 0;
+	try
+	{
+		RecordingDecoder decoder;
+		decoder.ReadHeader(stream);
+		FrameWriter writer(outputPrefix, codec);
+		while (auto *frame = decoder.Next(stream))
+		{
+			writer.Push(*frame);
+			frames += 1;
+		}
+		writer.Finish();
+		if (auto error = writer.GetError())
+		{
+			std::cerr << *error << std::endl;
+			return 2;
+		}
+	}
+	catch (const std::exception &e)
+	{
+		std::cerr << inputFilename << ": " << e.what();
+		if (frames)
+			std::cerr << " after " << frames << " frames";
+		std::cerr << std::endl;
+		return 2;
+	}
+	std::cout << frames << " frames extracted" << std::endl;
+	return 0;
+}
+
+static std::vector<ByteString> BatchInputs(ByteString source)
+{
+	std::vector<ByteString> inputs;
+	if (Platform::DirectoryExists(source))
+	{
+		if (source.back() != '/' && source.back() != '\\')
+			source.append(1, PATH_SEP_CHAR);
+		for (auto &name : Platform::DirectorySearch(source, "", { ".cps", ".stm" }))
+			inputs.push_back(source + name);
+		std::sort(inputs.begin(), inputs.end());
+		return inputs;
+	}
+	// Otherwise a manifest listing one save per line
+	std::vector<char> manifestData;
+	if (!Platform::ReadFile(manifestData, source))
+		return inputs;
+	std::istringstream manifest(std::string(manifestData.begin(), manifestData.end()));
+	std::string line;
+	while (std::getline(manifest, line))
+	{
+		if (line.size() && line.back() == '\r')
+			line.pop_back();
+		if (line.size())
+			inputs.push_back(line);
+	}
+	return inputs;
+}
+
+static ByteString BatchOutputFilename(const ByteString &outputDirectory, const ByteString &inputFilename)
+{
+	auto slash = inputFilename.find_last_of("/\\");
+	auto name = inputFilename.substr(slash == ByteString::npos ? 0 : slash + 1);
+	auto dot = name.rfind('.');
+	if (dot != ByteString::npos && dot > 0)
+		name = name.substr(0, dot);
+	return outputDirectory + PATH_SEP_CHAR + name + ".png";
+}
+
+static int RenderBatch(ByteString source, ByteString outputDirectory, const RenderOptions &options)
+{
+	auto inputs = BatchInputs(source);
+	if (inputs.empty())
+	{
+		std::cerr << "No saves found in " << source << std::endl;
+		return 1;
+	}
+	if (!Platform::DirectoryExists(outputDirectory) && !Platform::MakeDirectory(outputDirectory))
+	{
+		std::cerr << "Cannot create " << outputDirectory << std::endl;
+		return 1;
+	}
+	std::vector<BatchJob> jobs(inputs.size());
+	std::map<ByteString, ByteString> outputOwners;
+	for (size_t i = 0; i < inputs.size(); i++)
+	{
+		jobs[i].inputFilename = inputs[i];
+		jobs[i].outputFilename = BatchOutputFilename(outputDirectory, inputs[i]);
+		// Saves with the same name in different directories would overwrite each other's images
+		auto owner = outputOwners.emplace(jobs[i].outputFilename, inputs[i]);
+		if (!owner.second)
+		{
+			jobs[i].error = "same output file as " + owner.first->second;
+		}
+	}
+
+	int threadCount = options.threads;
+	if (threadCount <= 0)
+		threadCount = std::max(1U, std::thread::hardware_concurrency());
+	threadCount = std::min(threadCount, int(jobs.size()));
+	// Contexts are big and constructing them touches shared state, so do it
+	// up front on this thread; each worker then reuses its own.
+	std::vector<std::unique_ptr<RenderContext>> contexts;
+	for (int i = 0; i < threadCount; i++)
+		contexts.push_back(std::make_unique<RenderContext>());
+
+	std::atomic<size_t> nextJob = 0;
+	std::mutex reportMx;
+	auto worker = [&jobs, &nextJob, &reportMx, &options](RenderContext &ctx) {
+		while (true)
+		{
+			auto index = nextJob++;
+			if (index >= jobs.size())
+				break;
+			auto &job = jobs[index];
+			auto start = Platform::GetTime();
+			// Already failed if another save has the same output file
+			if (job.error.empty())
+			{
+				try
+				{
+					std::vector<char> fileData;
+					if (!Platform::ReadFile(fileData, job.inputFilename))
+						job.error = "cannot read save";
+					else if (!LoadSave(ctx, fileData, options))
+						job.error = "save file invalid";
+					else if (auto data = RenderPNG(ctx))
+					{
+						if (Platform::WriteFile(*data, job.outputFilename))
+							job.ok = true;
+						else
+							job.error = "cannot write " + job.outputFilename;
+					}
+					else
+						job.error = "cannot encode PNG";
+				}
+				catch (const std::exception &e)
+				{
+					job.error = e.what();
+				}
+			}
+			job.time = Platform::GetTime() - start;
+
+			std::lock_guard lk(reportMx);
+			if (job.ok)
+				std::cout << job.inputFilename << ": " << job.time << " ms" << std::endl;
+			else
+				std::cout << job.inputFilename << ": error: " << job.error << std::endl;
+		}
+	};
+	auto start = Platform::GetTime();
+	std::vector<std::thread> threads;
+	for (auto &ctx : contexts)
+		threads.emplace_back(worker, std::ref(*ctx));
+	for (auto &thread : threads)
+		thread.join();
+	auto total = Platform::GetTime() - start;
+
+	auto failed = std::count_if(jobs.begin(), jobs.end(), [](const BatchJob &job) {
+		return !job.ok;
+	});
+	std::cout << jobs.size() - failed << " rendered, " << failed << " failed, " << total << " ms total on " << threadCount << " threads" << std::endl;
+	return failed ? 2 : 0;
+}
+
+static void Usage(const char *argv0)
+{
+	std::cout << "Usage: " << argv0 << " [options] <inputFilename> <outputPrefix>" << std::endl;
+	std::cout << "       " << argv0 << " [options] --batch <inputDirectory|manifestFilename> <outputDirectory>" << std::endl;
+	std::cout << "       " << argv0 << " [--format png|ppm] --extract <recordingFilename> <outputPrefix>" << std::endl;
+	std::cout << "Options:" << std::endl;
+	std::cout << "  --preset <n>     render with render mode preset n, as numbered in the render options" << std::endl;
+	std::cout << "  --threads <n>    number of threads for --batch, defaults to one per core" << std::endl;
+	std::cout << "  --frames <n>     simulate n frames and write an animation instead of a single image" << std::endl;
+	std::cout << "  --every <k>      with --frames, write every kth frame" << std::endl;
+	std::cout << "  --format <f>     with --frames, png or ppm for numbered images, delta for a single " << RECORDING_EXTENSION << " file" << std::endl;
+	std::cout << "  --keyframes <k>  with --format delta, store every kth written frame whole" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+	auto simulationData = std::make_unique<SimulationData>();
+
+	RenderOptions options;
+	bool batch = false;
+	bool extract = false;
+	std::vector<ByteString> positional;
+	for (int i = 1; i < argc; i++)
+	{
+		auto arg = ByteString(argv[i]);
+		auto hasValue = i + 1 < argc;
+		auto number = [&]() {
+			return hasValue ? ByteString(argv[++i]).ToNumber<int>(true) : 0;
+		};
+		if (arg == "--batch")
+			batch = true;
+		else if (arg == "--extract")
+			extract = true;
+		else if (arg == "--threads")
+			options.threads = number();
+		else if (arg == "--preset")
+			options.preset = number();
+		else if (arg == "--frames")
+			options.frames = number();
+		else if (arg == "--every")
+			options.every = std::max(1, number());
+		else if (arg == "--keyframes")
+			options.keyframeInterval = std::max(1, number());
+		else if (arg == "--format" && hasValue)
+		{
+			auto codec = FrameWriter::CodecFromName(argv[++i]);
+			if (!codec)
+			{
+				Usage(argv[0]);
+				return 1;
+			}
+			options.codec = *codec;
+		}
+		else
+			positional.push_back(arg);
 	}
+	if (positional.size() != 2)
+	{
+		Usage(argv[0]);
+		return 1;
+	}
+
+	if (extract)
+	{
+		return ExtractRecording(positional[0], positional[1], options);
+	}
+	if (batch)
+	{
+		return RenderBatch(positional[0], positional[1], options);
+	}
+	if (options.frames > 0)
+	{
+		return RenderAnimation(positional[0], positional[1], options);
+	}
+	auto inputFilename = positional[0];
+	auto outputFilename = positional[1] + ".png";
 
-	ren->RenderBegin();
-	ren->RenderEnd();
+	std::vector<char> fileData;
+	if (!Platform::ReadFile(fileData, inputFilename))
+	{
+		return 1;
+	}
 
-	if (auto data = ren->DumpFrame().ToPNG())
+	RenderContext ctx;
+	if (auto data = RenderSave(ctx, fileData, options))
 		Platform::WriteFile(*data, outputFilename);
 }
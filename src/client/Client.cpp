@@ -24,12 +24,12 @@
 #include <fstream>
 #include <chrono>
 #include <algorithm>
-#include <set>
 
 Client::Client():
 	messageOfTheDay("Fetching the message of the day..."),
 	usingAltUpdateServer(false),
 	updateAvailable(false),
+	stampIndex(STAMPS_DIR),
 	authUser(0, "")
 {
 	LoadAuthUser();
@@ -37,19 +37,6 @@ Client::Client():
 	firstRun = !prefs.BackedByFile();
 }
 
-void Client::MigrateStampsDef()
-{
-	std::vector<char> data;
-	if (!Platform::ReadFile(data, ByteString::Build(STAMPS_DIR, PATH_SEP_CHAR, "stamps.def")))
-	{
-		return;
-	}
-	for (auto i = 0; i < int(data.size()); i += 10)
-	{
-		stampIDs.push_back(ByteString(&data[0] + i, &data[0] + i + 10));
-	}
-}
-
 void Client::Initialize()
 {
 	auto &prefs = GlobalPrefs::Ref();
@@ -59,17 +46,7 @@ void Client::Initialize()
 		Platform::UpdateFinish();
 	}
 
-	stamps = std::make_unique<Prefs>(ByteString::Build(STAMPS_DIR, PATH_SEP_CHAR, "stamps.json"));
-	stampIDs = stamps->Get("MostRecentlyUsedFirst", std::vector<ByteString>{});
-	{
-		Prefs::DeferWrite dw(*stamps);
-		if (!stamps->BackedByFile())
-		{
-			MigrateStampsDef();
-			WriteStamps();
-		}
-		RescanStamps();
-	}
+	stampIndex.Load();
 
 	//Begin version check
 	versionCheckRequest = std::make_unique<http::StartupRequest>(false);
@@ -112,6 +89,8 @@ std::vector<ServerNotification> Client::GetServerNotifications()
 
 void Client::Tick()
 {
+	saveWriter.Tick();
+	stampIndex.Poll();
 	auto applyUpdateInfo = false;
 	if (versionCheckRequest && versionCheckRequest->CheckDone())
 	{
@@ -246,31 +225,15 @@ User Client::GetAuthUser()
 
 void Client::MoveStampToFront(ByteString stampID)
 {
-	auto it = std::find(stampIDs.begin(), stampIDs.end(), stampID);
-	auto changed = false;
-	if (it == stampIDs.end())
-	{
-		stampIDs.push_back(stampID);
-		it = stampIDs.end() - 1;
-		changed = true;
-	}
-	else if (it != stampIDs.begin())
-	{
-		changed = true;
-	}
-	if (changed)
-	{
-		std::rotate(stampIDs.begin(), it, it + 1);
-		WriteStamps();
-	}
+	stampIndex.MoveToFront(stampID);
 }
 
-std::unique_ptr<SaveFile> Client::GetStamp(ByteString stampID)
+std::unique_ptr<SaveFile> Client::GetStamp(ByteString stampID, bool lazyLoad)
 {
 	ByteString stampFile = ByteString(ByteString::Build(STAMPS_DIR, PATH_SEP_CHAR, stampID, ".stm"));
-	auto saveFile = LoadSaveFile(stampFile);
+	auto saveFile = LoadSaveFile(stampFile, lazyLoad);
 	if (!saveFile)
-		saveFile = LoadSaveFile(stampID);
+		saveFile = LoadSaveFile(stampID, lazyLoad);
 	else
 		saveFile->SetDisplayName(stampID.FromUtf8());
 	return saveFile;
@@ -278,34 +241,24 @@ std::unique_ptr<SaveFile> Client::GetStamp(ByteString stampID)
 
 void Client::DeleteStamp(ByteString stampID)
 {
-	auto it = std::remove(stampIDs.begin(), stampIDs.end(), stampID);
-	if (it != stampIDs.end())
-	{
-		stampIDs.erase(it, stampIDs.end());
-		Platform::RemoveFile(ByteString::Build(STAMPS_DIR, PATH_SEP_CHAR, stampID, ".stm"));
-		WriteStamps();
-	}
+	saveWriter.Flush(ByteString::Build(STAMPS_DIR, PATH_SEP_CHAR, stampID, ".stm"));
+	stampIndex.Remove(stampID);
 }
 
 void Client::RenameStamp(ByteString stampID, ByteString newName)
 {
-	auto oldPath = ByteString::Build(STAMPS_DIR, PATH_SEP_CHAR, stampID, ".stm");
-	auto newPath = ByteString::Build(STAMPS_DIR, PATH_SEP_CHAR, newName, ".stm");
-
-	if (Platform::FileExists(newPath))
+	if (Platform::FileExists(ByteString::Build(STAMPS_DIR, PATH_SEP_CHAR, newName, ".stm")))
 	{
 		new ErrorMessage("Error renaming stamp", "A stamp with this name already exists.");
 		return;
 	}
 
-	if (!Platform::RenameFile(oldPath, newPath, false))
+	saveWriter.Flush(ByteString::Build(STAMPS_DIR, PATH_SEP_CHAR, stampID, ".stm"));
+	if (!stampIndex.Rename(stampID, newName))
 	{
 		new ErrorMessage("Error renaming stamp", "Could not rename the stamp.");
 		return;
 	}
-
-	std::replace(stampIDs.begin(), stampIDs.end(), stampID, newName);
-	WriteStamps();
 }
 
 ByteString Client::AddStamp(std::unique_ptr<GameSave> saveData)
@@ -325,15 +278,13 @@ ByteString Client::AddStamp(std::unique_ptr<GameSave> saveData)
 	{
 		saveID = ByteString::Build(Format::Hex(Format::Width(lastStampTime, 8)), Format::Hex(Format::Width(lastStampName, 2)));
 		filename = ByteString::Build(STAMPS_DIR, PATH_SEP_CHAR, saveID, ".stm");
-		if (!Platform::FileExists(filename))
+		if (!stampIndex.Contains(saveID) && !Platform::FileExists(filename))
 		{
 			break;
 		}
 		lastStampName += 1;
 	}
 
-	Platform::MakeDirectory(STAMPS_DIR);
-
 	Json::Value stampInfo;
 	stampInfo["type"] = "stamp";
 	stampInfo["username"] = authUser.Username;
@@ -346,71 +297,62 @@ ByteString Client::AddStamp(std::unique_ptr<GameSave> saveData)
 	}
 	saveData->authors = stampInfo;
 
-	std::vector<char> gameData;
-	std::tie(std::ignore, gameData) = saveData->Serialise();
-	if (!gameData.size())
-		return "";
-
-	Platform::WriteFile(gameData, filename);
-	MoveStampToFront(saveID);
+	stampIndex.BeginAdd(saveID);
+	SaveWriter::Job job;
+	job.path = filename;
+	job.save = std::move(saveData);
+	job.compression = GameSave::compressionZlib;
+	job.onDone = [this, saveID](const SaveWriter::Result &result) {
+		stampIndex.EndAdd(saveID, result.error.empty());
+		if (result.error.size())
+		{
+			new ErrorMessage("Could not create stamp", result.error);
+		}
+	};
+	saveWriter.Write(std::move(job));
 	return saveID;
 }
 
 void Client::RescanStamps()
 {
-	ByteString extension = ".stm";
-	std::set<ByteString> stampFilesSet;
-	for (auto &stampID : Platform::DirectorySearch("stamps", "", { extension }))
-	{
-		stampFilesSet.insert(stampID.substr(0, stampID.size() - extension.size()));
-	}
-	std::vector<ByteString> newStampIDs;
-	auto changed = false;
-	for (auto &stampID : stampIDs)
-	{
-		if (stampFilesSet.find(stampID) == stampFilesSet.end())
-		{
-			changed = true;
-		}
-		else
-		{
-			newStampIDs.push_back(stampID);
-		}
-	}
-	auto stampIDsSet = std::set<ByteString>(stampIDs.begin(), stampIDs.end());
-	for (auto &stampID : stampFilesSet)
-	{
-		if (stampIDsSet.find(stampID) == stampIDsSet.end())
-		{
-			newStampIDs.push_back(stampID);
-			changed = true;
-		}
-	}
-	if (changed)
-	{
-		stampIDs = newStampIDs;
-		WriteStamps();
-	}
+	stampIndex.Rescan();
+}
+
+const std::vector<ByteString> &Client::GetStamps() const
+{
+	return stampIndex.GetIDs();
 }
 
-void Client::WriteStamps()
+void Client::WriteSaveFile(SaveWriter::Job job)
 {
-	if (stampIDs.size())
-	{
-		stamps->Set("MostRecentlyUsedFirst", stampIDs);
-	}
+	saveWriter.Write(std::move(job));
 }
 
-const std::vector<ByteString> &Client::GetStamps() const
+void Client::FlushSaveFile(const ByteString &filename)
+{
+	saveWriter.Flush(filename);
+}
+
+void Client::FlushSaveFiles()
 {
-	return stampIDs;
+	saveWriter.Flush();
 }
 
-std::unique_ptr<SaveFile> Client::LoadSaveFile(ByteString filename)
+void Client::FinishSaveFiles()
 {
+	saveWriter.Finish();
+}
+
+std::unique_ptr<SaveFile> Client::LoadSaveFile(ByteString filename, bool lazyLoad)
+{
+	saveWriter.Flush(filename);
 	ByteString err;
 	std::unique_ptr<SaveFile> file;
-	if (Platform::FileExists(filename))
+	if (Platform::FileExists(filename) && lazyLoad)
+	{
+		file = std::make_unique<SaveFile>(filename, true);
+	}
+	else if (Platform::FileExists(filename))
 	{
 		file = std::make_unique<SaveFile>(filename);
 		try
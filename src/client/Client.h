@@ -3,6 +3,8 @@
 #include "common/ExplicitSingleton.h"
 #include "StartupInfo.h"
 #include "User.h"
+#include "StampIndex.h"
+#include "SaveWriter.h"
 #include <vector>
 #include <cstdint>
 #include <list>
@@ -34,7 +36,8 @@ private:
 
 	bool firstRun;
 
-	std::vector<ByteString> stampIDs;
+	StampIndex stampIndex;
+	SaveWriter saveWriter;
 	uint64_t lastStampTime = 0;
 	int lastStampName = 0;
 
@@ -49,10 +52,6 @@ private:
 	// Save stealing info
 	Json::Value authors;
 
-	std::unique_ptr<Prefs> stamps;
-	void MigrateStampsDef();
-	void WriteStamps();
-
 	void LoadAuthUser();
 	void SaveAuthUser();
 
@@ -89,7 +88,8 @@ public:
 	void AddListener(ClientListener * listener);
 	void RemoveListener(ClientListener * listener);
 
-	std::unique_ptr<SaveFile> GetStamp(ByteString stampID);
+	// With lazyLoad, the save is only read once something asks for it.
+	std::unique_ptr<SaveFile> GetStamp(ByteString stampID, bool lazyLoad = false);
 	void DeleteStamp(ByteString stampID);
 	void RenameStamp(ByteString stampID, ByteString newName);
 	ByteString AddStamp(std::unique_ptr<GameSave> saveData);
@@ -97,7 +97,13 @@ public:
 	const std::vector<ByteString> &GetStamps() const;
 	void MoveStampToFront(ByteString stampID);
 
-	std::unique_ptr<SaveFile> LoadSaveFile(ByteString filename);
+	std::unique_ptr<SaveFile> LoadSaveFile(ByteString filename, bool lazyLoad = false);
+	// Serialises and writes the save in the background; see SaveWriter.
+	void WriteSaveFile(SaveWriter::Job job);
+	void FlushSaveFile(const ByteString &filename);
+	void FlushSaveFiles();
+	// For use at exit; see SaveWriter::Finish.
+	void FinishSaveFiles();
 
 	void SetAuthUser(User user);
 	User GetAuthUser();
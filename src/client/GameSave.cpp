@@ -1,5 +1,6 @@
 #include "GameSave.h"
 #include "bzip2/bz2wrap.h"
+#include "zlib/zlibwrap.h"
 #include "Format.h"
 #include "simulation/Simulation.h"
 #include "simulation/ElementClasses.h"
@@ -15,6 +16,10 @@
 #include <set>
 #include <cmath>
 #include <algorithm>
+#include <exception>
+#include <functional>
+#include <system_error>
+#include <thread>
 
 constexpr auto currentVersion   = UPSTREAM_VERSION.displayVersion;
 constexpr auto nextVersion      = Version(98, 0);
@@ -140,7 +145,7 @@ void GameSave::Expand(const std::vector<char> &data)
 		}
 		else if(data[0] == 'O' && data[1] == 'P' && data[2] == 'S')
 		{
-			if (data[3] != '1')
+			if (data[3] != '1' && data[3] != 'Z')
 				throw ParseException(ParseException::WrongVersion, "Save format from newer version");
 			readOPS(data);
 		}
@@ -180,11 +185,11 @@ void GameSave::setSize(Vec2<int> newBlockSize)
 	blockAirh = PlaneAdapter<std::vector<unsigned char>>(blockSize, 0);
 }
 
-std::pair<bool, std::vector<char>> GameSave::Serialise() const
+std::pair<bool, std::vector<char>> GameSave::Serialise(Compression compression) const
 {
 	try
 	{
-		return serialiseOPS();
+		return serialiseOPS(compression);
 	}
 	catch (const std::bad_alloc &)
 	{
@@ -406,6 +411,56 @@ static void CheckBsonFieldFloat(bson_iterator iter, const char *field, float *se
 	}
 }
 
+// Runs jobs concurrently, the first one on the calling thread, and rethrows the
+// exception thrown by the first job in the list that threw one.
+static void runConcurrently(const std::vector<std::function<void ()>> &jobs)
+{
+	std::vector<std::exception_ptr> errors(jobs.size());
+	auto run = [&jobs, &errors](size_t i) {
+		try
+		{
+			jobs[i]();
+		}
+		catch (...)
+		{
+			errors[i] = std::current_exception();
+		}
+	};
+	auto concurrent = std::thread::hardware_concurrency() > 1;
+	std::vector<std::thread> threads;
+	for (size_t i = 1; i < jobs.size(); i++)
+	{
+		if (!concurrent)
+		{
+			run(i);
+			continue;
+		}
+		try
+		{
+			threads.emplace_back(run, i);
+		}
+		catch (const std::system_error &)
+		{
+			run(i);
+		}
+	}
+	if (jobs.size())
+	{
+		run(0);
+	}
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+	for (auto &error : errors)
+	{
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+	}
+}
+
 void GameSave::readOPS(const std::vector<char> &data)
 {
 	auto &builtinGol = SimulationData::builtinGol;
@@ -421,11 +476,10 @@ void GameSave::readOPS(const std::vector<char> &data)
 	version = { savedVersion, 0 };
 	bool fakeNewerVersion = false; // used for development builds only
 
+	// b only borrows bsonData, so bson_destroy, which would free it, is never called
 	bson b;
 	b.data = NULL;
-	auto bson_deleter = [](bson * b) { bson_destroy(b); };
-	// Use unique_ptr with a custom deleter to ensure that bson_destroy is called even when an exception is thrown
-	std::unique_ptr<bson, decltype(bson_deleter)> b_ptr(&b, bson_deleter);
+	std::vector<char> bsonData;
 
 	//Block sizes
 	auto blockP = Vec2{ 0, 0 };
@@ -459,23 +513,30 @@ void GameSave::readOPS(const std::vector<char> &data)
 		throw ParseException(ParseException::InvalidDimensions, "Save data too large, refusing");
 
 	{
-		std::vector<char> bsonData;
-		switch (auto status = BZ2WDecompress(bsonData, (char *)(inputData + 12), inputDataLen - 12, toAlloc))
+		if (inputData[3] == 'Z')
 		{
-		case BZ2WDecompressOk: break;
-		case BZ2WDecompressNomem: throw ParseException(ParseException::Corrupt, "Cannot allocate memory");
-		default: throw ParseException(ParseException::Corrupt, String::Build("Cannot decompress: status ", int(status)));
+			switch (auto status = ZlibWDecompress(bsonData, (char *)(inputData + 12), inputDataLen - 12, toAlloc))
+			{
+			case ZlibWDecompressOk: break;
+			case ZlibWDecompressNomem: throw ParseException(ParseException::Corrupt, "Cannot allocate memory");
+			default: throw ParseException(ParseException::Corrupt, String::Build("Cannot decompress: status ", int(status)));
+			}
+		}
+		else
+		{
+			switch (auto status = BZ2WDecompress(bsonData, (char *)(inputData + 12), inputDataLen - 12, toAlloc))
+			{
+			case BZ2WDecompressOk: break;
+			case BZ2WDecompressNomem: throw ParseException(ParseException::Corrupt, "Cannot allocate memory");
+			default: throw ParseException(ParseException::Corrupt, String::Build("Cannot decompress: status ", int(status)));
+			}
 		}
 
 		bsonDataLen = bsonData.size();
 		//Make sure bsonData is null terminated, since all string functions need null terminated strings
 		//(bson_iterator_key returns a pointer into bsonData, which is then used with strcmp)
 		bsonData.push_back(0);
-
-		// apparently bson_* takes ownership of the data passed into it?????????
-		auto *pleaseFixMe = (char *)malloc(bsonData.size());
-		std::copy(bsonData.begin(), bsonData.end(), pleaseFixMe);
-		bson_init_data_size(&b, pleaseFixMe, bsonDataLen);
+		bson_init_data_size(&b, bsonData.data(), bsonDataLen);
 	}
 
 	set_bson_err_handler([](const char* err) { throw ParseException(ParseException::Corrupt, "BSON error when parsing save: " + ByteString(err).FromUtf8()); });
@@ -748,480 +809,489 @@ void GameSave::readOPS(const std::vector<char> &data)
 	paletteRemap(Version(92, 0), "DEFAULT_PT_E182", "DEFAULT_PT_POLO");
 	paletteRemap(Version(93, 3), "DEFAULT_PT_RAYT", "DEFAULT_PT_LDTC");
 
-	//Read wall and fan data
-	if(wallData)
-	{
-		// TODO: use PlaneAdapter<std::span<unsigned char>> once we're C++20
-		auto wallDataPlane = PlaneAdapter<const std::basic_string_view<unsigned char>>(blockS, std::in_place, wallData, blockS.X * blockS.Y);
-		unsigned int j = 0;
-		if (blockS.X * blockS.Y > int(wallDataLen))
-			throw ParseException(ParseException::Corrupt, "Not enough wall data");
-		for (auto bpos : blockS.OriginRect().Range<LEFT_TO_RIGHT, TOP_TO_BOTTOM>())
+	// The sections below are independent of each other and are read concurrently
+	auto readWalls = [&]() {
+		//Read wall and fan data
+		if(wallData)
 		{
-			unsigned char bm = 0;
-			if (wallDataPlane[bpos])
-				bm = wallDataPlane[bpos];
-
-			switch (bm)
+			// TODO: use PlaneAdapter<std::span<unsigned char>> once we're C++20
+			auto wallDataPlane = PlaneAdapter<const std::basic_string_view<unsigned char>>(blockS, std::in_place, wallData, blockS.X * blockS.Y);
+			unsigned int j = 0;
+			if (blockS.X * blockS.Y > int(wallDataLen))
+				throw ParseException(ParseException::Corrupt, "Not enough wall data");
+			for (auto bpos : blockS.OriginRect().Range<LEFT_TO_RIGHT, TOP_TO_BOTTOM>())
 			{
-			case O_WL_WALLELEC:     bm = WL_WALLELEC;     break;
-			case O_WL_EWALL:        bm = WL_EWALL;        break;
-			case O_WL_DETECT:       bm = WL_DETECT;       break;
-			case O_WL_STREAM:       bm = WL_STREAM;       break;
-			case O_WL_FAN:
-			case O_WL_FANHELPER:    bm = WL_FAN;          break;
-			case O_WL_ALLOWLIQUID:  bm = WL_ALLOWLIQUID;  break;
-			case O_WL_DESTROYALL:   bm = WL_DESTROYALL;   break;
-			case O_WL_ERASE:        bm = WL_ERASE;        break;
-			case O_WL_WALL:         bm = WL_WALL;         break;
-			case O_WL_ALLOWAIR:     bm = WL_ALLOWAIR;     break;
-			case O_WL_ALLOWSOLID:   bm = WL_ALLOWPOWDER;  break;
-			case O_WL_ALLOWALLELEC: bm = WL_ALLOWALLELEC; break;
-			case O_WL_EHOLE:        bm = WL_EHOLE;        break;
-			case O_WL_ALLOWGAS:     bm = WL_ALLOWGAS;     break;
-			case O_WL_GRAV:         bm = WL_GRAV;         break;
-			case O_WL_ALLOWENERGY:  bm = WL_ALLOWENERGY;  break;
-			}
-
-			if (bm == WL_FAN && fanData)
-			{
-				if(j+1 >= fanDataLen)
+				unsigned char bm = 0;
+				if (wallDataPlane[bpos])
+					bm = wallDataPlane[bpos];
+
+				switch (bm)
 				{
-					fprintf(stderr, "Not enough fan data\n");
+				case O_WL_WALLELEC:     bm = WL_WALLELEC;     break;
+				case O_WL_EWALL:        bm = WL_EWALL;        break;
+				case O_WL_DETECT:       bm = WL_DETECT;       break;
+				case O_WL_STREAM:       bm = WL_STREAM;       break;
+				case O_WL_FAN:
+				case O_WL_FANHELPER:    bm = WL_FAN;          break;
+				case O_WL_ALLOWLIQUID:  bm = WL_ALLOWLIQUID;  break;
+				case O_WL_DESTROYALL:   bm = WL_DESTROYALL;   break;
+				case O_WL_ERASE:        bm = WL_ERASE;        break;
+				case O_WL_WALL:         bm = WL_WALL;         break;
+				case O_WL_ALLOWAIR:     bm = WL_ALLOWAIR;     break;
+				case O_WL_ALLOWSOLID:   bm = WL_ALLOWPOWDER;  break;
+				case O_WL_ALLOWALLELEC: bm = WL_ALLOWALLELEC; break;
+				case O_WL_EHOLE:        bm = WL_EHOLE;        break;
+				case O_WL_ALLOWGAS:     bm = WL_ALLOWGAS;     break;
+				case O_WL_GRAV:         bm = WL_GRAV;         break;
+				case O_WL_ALLOWENERGY:  bm = WL_ALLOWENERGY;  break;
 				}
-				fanVelX[blockP + bpos] = (fanData[j++]-127.0f)/64.0f;
-				fanVelY[blockP + bpos] = (fanData[j++]-127.0f)/64.0f;
-			}
 
-			if (bm >= UI_WALLCOUNT)
-				bm = 0;
-			blockMap[blockP + bpos] = bm;
+				if (bm == WL_FAN && fanData)
+				{
+					if(j+1 >= fanDataLen)
+					{
+						fprintf(stderr, "Not enough fan data\n");
+					}
+					fanVelX[blockP + bpos] = (fanData[j++]-127.0f)/64.0f;
+					fanVelY[blockP + bpos] = (fanData[j++]-127.0f)/64.0f;
+				}
+
+				if (bm >= UI_WALLCOUNT)
+					bm = 0;
+				blockMap[blockP + bpos] = bm;
+			}
 		}
-	}
+	};
 
-	//Read pressure data
-	if (pressData)
-	{
-		unsigned int j = 0;
-		unsigned char i, i2;
-		if (blockS.X * blockS.Y > int(pressDataLen))
-			throw ParseException(ParseException::Corrupt, "Not enough pressure data");
-		for (auto bpos : blockS.OriginRect().Range<LEFT_TO_RIGHT, TOP_TO_BOTTOM>())
+	auto readAir = [&]() {
+		//Read pressure data
+		if (pressData)
 		{
-			i = pressData[j++];
-			i2 = pressData[j++];
-			pressure[blockP + bpos] = ((i+(i2<<8))/128.0f)-256;
+			unsigned int j = 0;
+			unsigned char i, i2;
+			if (blockS.X * blockS.Y > int(pressDataLen))
+				throw ParseException(ParseException::Corrupt, "Not enough pressure data");
+			for (auto bpos : blockS.OriginRect().Range<LEFT_TO_RIGHT, TOP_TO_BOTTOM>())
+			{
+				i = pressData[j++];
+				i2 = pressData[j++];
+				pressure[blockP + bpos] = ((i+(i2<<8))/128.0f)-256;
+			}
+			hasPressure = true;
 		}
-		hasPressure = true;
-	}
 
-	//Read vx data
-	if (vxData)
-	{
-		unsigned int j = 0;
-		unsigned char i, i2;
-		if (blockS.X * blockS.Y > int(vxDataLen))
-			throw ParseException(ParseException::Corrupt, "Not enough vx data");
-		for (auto bpos : blockS.OriginRect().Range<LEFT_TO_RIGHT, TOP_TO_BOTTOM>())
+		//Read vx data
+		if (vxData)
 		{
-			i = vxData[j++];
-			i2 = vxData[j++];
-			velocityX[blockP + bpos] = ((i+(i2<<8))/128.0f)-256;
+			unsigned int j = 0;
+			unsigned char i, i2;
+			if (blockS.X * blockS.Y > int(vxDataLen))
+				throw ParseException(ParseException::Corrupt, "Not enough vx data");
+			for (auto bpos : blockS.OriginRect().Range<LEFT_TO_RIGHT, TOP_TO_BOTTOM>())
+			{
+				i = vxData[j++];
+				i2 = vxData[j++];
+				velocityX[blockP + bpos] = ((i+(i2<<8))/128.0f)-256;
+			}
 		}
-	}
 
-	//Read vy data
-	if (vyData)
-	{
-		unsigned int j = 0;
-		unsigned char i, i2;
-		if (blockS.X * blockS.Y > int(vyDataLen))
-			throw ParseException(ParseException::Corrupt, "Not enough vy data");
-		for (auto bpos : blockS.OriginRect().Range<LEFT_TO_RIGHT, TOP_TO_BOTTOM>())
+		//Read vy data
+		if (vyData)
 		{
-			i = vyData[j++];
-			i2 = vyData[j++];
-			velocityY[blockP + bpos] = ((i+(i2<<8))/128.0f)-256;
+			unsigned int j = 0;
+			unsigned char i, i2;
+			if (blockS.X * blockS.Y > int(vyDataLen))
+				throw ParseException(ParseException::Corrupt, "Not enough vy data");
+			for (auto bpos : blockS.OriginRect().Range<LEFT_TO_RIGHT, TOP_TO_BOTTOM>())
+			{
+				i = vyData[j++];
+				i2 = vyData[j++];
+				velocityY[blockP + bpos] = ((i+(i2<<8))/128.0f)-256;
+			}
 		}
-	}
 
-	//Read ambient data
-	if (ambientData)
-	{
-		unsigned int i = 0, tempTemp;
-		if (blockS.X * blockS.Y > int(ambientDataLen))
-			throw ParseException(ParseException::Corrupt, "Not enough ambient heat data");
-		for (auto bpos : blockS.OriginRect().Range<LEFT_TO_RIGHT, TOP_TO_BOTTOM>())
+		//Read ambient data
+		if (ambientData)
 		{
-			tempTemp = ambientData[i++];
-			tempTemp |= (((unsigned)ambientData[i++]) << 8);
-			ambientHeat[blockP + bpos] = float(tempTemp);
+			unsigned int i = 0, tempTemp;
+			if (blockS.X * blockS.Y > int(ambientDataLen))
+				throw ParseException(ParseException::Corrupt, "Not enough ambient heat data");
+			for (auto bpos : blockS.OriginRect().Range<LEFT_TO_RIGHT, TOP_TO_BOTTOM>())
+			{
+				tempTemp = ambientData[i++];
+				tempTemp |= (((unsigned)ambientData[i++]) << 8);
+				ambientHeat[blockP + bpos] = float(tempTemp);
+			}
+			hasAmbientHeat = true;
 		}
-		hasAmbientHeat = true;
-	}
 
-	if (blockAirData)
-	{
-		if (blockS.X * blockS.Y * 2 > int(blockAirDataLen))
-			throw ParseException(ParseException::Corrupt, "Not enough block air data");
-		// TODO: use PlaneAdapter<std::span<unsigned char>> once we're C++20
-		auto blockAirDataPlane = PlaneAdapter<const std::basic_string_view<unsigned char>>(blockS, std::in_place, blockAirData, blockS.X * blockS.Y);
-		auto blockAirhDataPlane = PlaneAdapter<const std::basic_string_view<unsigned char>>(blockS, std::in_place, blockAirData + blockS.X * blockS.Y, blockS.X * blockS.Y);
-		for (auto bpos : blockS.OriginRect().Range<LEFT_TO_RIGHT, TOP_TO_BOTTOM>())
+		if (blockAirData)
 		{
-			blockAir[blockP + bpos] = blockAirDataPlane[bpos];
-			blockAirh[blockP + bpos] = blockAirhDataPlane[bpos];
+			if (blockS.X * blockS.Y * 2 > int(blockAirDataLen))
+				throw ParseException(ParseException::Corrupt, "Not enough block air data");
+			// TODO: use PlaneAdapter<std::span<unsigned char>> once we're C++20
+			auto blockAirDataPlane = PlaneAdapter<const std::basic_string_view<unsigned char>>(blockS, std::in_place, blockAirData, blockS.X * blockS.Y);
+			auto blockAirhDataPlane = PlaneAdapter<const std::basic_string_view<unsigned char>>(blockS, std::in_place, blockAirData + blockS.X * blockS.Y, blockS.X * blockS.Y);
+			for (auto bpos : blockS.OriginRect().Range<LEFT_TO_RIGHT, TOP_TO_BOTTOM>())
+			{
+				blockAir[blockP + bpos] = blockAirDataPlane[bpos];
+				blockAirh[blockP + bpos] = blockAirhDataPlane[bpos];
+			}
+			hasBlockAirMaps = true;
 		}
-		hasBlockAirMaps = true;
-	}
+	};
 
-	//Read particle data
-	if (partsData && partsPosData)
-	{
-		int newIndex = 0, tempTemp;
-		int posCount, posTotal, partsPosDataIndex = 0;
-		if (partS.X * partS.Y * 3 > int(partsPosDataLen))
-			throw ParseException(ParseException::Corrupt, "Not enough particle position data");
+	auto readParticles = [&]() {
+		//Read particle data
+		if (partsData && partsPosData)
+		{
+			int newIndex = 0, tempTemp;
+			int posCount, posTotal, partsPosDataIndex = 0;
+			if (partS.X * partS.Y * 3 > int(partsPosDataLen))
+				throw ParseException(ParseException::Corrupt, "Not enough particle position data");
 
-		partsCount = 0;
+			partsCount = 0;
 
-		unsigned int i = 0;
-		newIndex = 0;
-		for (auto pos : RectSized(partP, partS).Range<TOP_TO_BOTTOM, LEFT_TO_RIGHT>())
-		{
-			//Read total number of particles at this position
-			posTotal = 0;
-			posTotal |= partsPosData[partsPosDataIndex++]<<16;
-			posTotal |= partsPosData[partsPosDataIndex++]<<8;
-			posTotal |= partsPosData[partsPosDataIndex++];
-			//Put the next posTotal particles at this position
-			for (posCount = 0; posCount < posTotal; posCount++)
-			{
-				particlesCount = newIndex+1;
-				//i+3 because we have 4 bytes of required fields (type (1), descriptor (2), temp (1))
-				if (i+3 >= partsDataLen)
-					throw ParseException(ParseException::Corrupt, "Ran past particle data buffer");
-				unsigned int fieldDescriptor = (unsigned int)(partsData[i+1]);
-				fieldDescriptor |= (unsigned int)(partsData[i+2]) << 8;
-
-				if (newIndex < 0 || newIndex >= NPART)
-					throw ParseException(ParseException::Corrupt, "Too many particles");
-
-				//Clear the particle, ready for our new properties
-				memset(&(particles[newIndex]), 0, sizeof(Particle));
-
-				//Required fields
-				particles[newIndex].type = partsData[i];
-				particles[newIndex].x = float(pos.X);
-				particles[newIndex].y = float(pos.Y);
-				i+=3;
-
-				// Read type (2nd byte)
-				if (fieldDescriptor & 0x4000)
-					particles[newIndex].type |= (((unsigned)partsData[i++]) << 8);
-
-				//Read temp
-				if(fieldDescriptor & 0x01)
-				{
-					//Full 16bit int
-					tempTemp = partsData[i++];
-					tempTemp |= (((unsigned)partsData[i++]) << 8);
-					particles[newIndex].temp = float(tempTemp);
-				}
-				else
+			unsigned int i = 0;
+			newIndex = 0;
+			for (auto pos : RectSized(partP, partS).Range<TOP_TO_BOTTOM, LEFT_TO_RIGHT>())
+			{
+				//Read total number of particles at this position
+				posTotal = 0;
+				posTotal |= partsPosData[partsPosDataIndex++]<<16;
+				posTotal |= partsPosData[partsPosDataIndex++]<<8;
+				posTotal |= partsPosData[partsPosDataIndex++];
+				//Put the next posTotal particles at this position
+				for (posCount = 0; posCount < posTotal; posCount++)
 				{
-					//1 Byte room temp offset
-					tempTemp = partsData[i++];
-					if (tempTemp >= 0x80)
+					particlesCount = newIndex+1;
+					//i+3 because we have 4 bytes of required fields (type (1), descriptor (2), temp (1))
+					if (i+3 >= partsDataLen)
+						throw ParseException(ParseException::Corrupt, "Ran past particle data buffer");
+					unsigned int fieldDescriptor = (unsigned int)(partsData[i+1]);
+					fieldDescriptor |= (unsigned int)(partsData[i+2]) << 8;
+
+					if (newIndex < 0 || newIndex >= NPART)
+						throw ParseException(ParseException::Corrupt, "Too many particles");
+
+					//Clear the particle, ready for our new properties
+					memset(&(particles[newIndex]), 0, sizeof(Particle));
+
+					//Required fields
+					particles[newIndex].type = partsData[i];
+					particles[newIndex].x = float(pos.X);
+					particles[newIndex].y = float(pos.Y);
+					i+=3;
+
+					// Read type (2nd byte)
+					if (fieldDescriptor & 0x4000)
+						particles[newIndex].type |= (((unsigned)partsData[i++]) << 8);
+
+					//Read temp
+					if(fieldDescriptor & 0x01)
 					{
-						tempTemp -= 0x100;
+						//Full 16bit int
+						tempTemp = partsData[i++];
+						tempTemp |= (((unsigned)partsData[i++]) << 8);
+						particles[newIndex].temp = float(tempTemp);
+					}
+					else
+					{
+						//1 Byte room temp offset
+						tempTemp = partsData[i++];
+						if (tempTemp >= 0x80)
+						{
+							tempTemp -= 0x100;
+						}
+						particles[newIndex].temp = tempTemp+294.15f;
 					}
-					particles[newIndex].temp = tempTemp+294.15f;
-				}
 
-				// fieldDesc3
-				if (fieldDescriptor & 0x8000)
-				{
-					if (i >= partsDataLen)
-						throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading third byte of field descriptor");
-					fieldDescriptor |= (unsigned int)(partsData[i++]) << 16;
-				}
+					// fieldDesc3
+					if (fieldDescriptor & 0x8000)
+					{
+						if (i >= partsDataLen)
+							throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading third byte of field descriptor");
+						fieldDescriptor |= (unsigned int)(partsData[i++]) << 16;
+					}
 
-				//Read life
-				if(fieldDescriptor & 0x02)
-				{
-					if (i >= partsDataLen)
-						throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading life");
-					particles[newIndex].life = partsData[i++];
-					//i++;
-					//Read 2nd byte
-					if(fieldDescriptor & 0x04)
+					//Read life
+					if(fieldDescriptor & 0x02)
 					{
 						if (i >= partsDataLen)
 							throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading life");
-						particles[newIndex].life |= (((unsigned)partsData[i++]) << 8);
+						particles[newIndex].life = partsData[i++];
+						//i++;
+						//Read 2nd byte
+						if(fieldDescriptor & 0x04)
+						{
+							if (i >= partsDataLen)
+								throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading life");
+							particles[newIndex].life |= (((unsigned)partsData[i++]) << 8);
+						}
 					}
-				}
 
-				//Read tmp
-				if(fieldDescriptor & 0x08)
-				{
-					if (i >= partsDataLen)
-						throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading tmp");
-					particles[newIndex].tmp = partsData[i++];
-					//Read 2nd byte
-					if(fieldDescriptor & 0x10)
+					//Read tmp
+					if(fieldDescriptor & 0x08)
 					{
 						if (i >= partsDataLen)
 							throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading tmp");
-						particles[newIndex].tmp |= (((unsigned)partsData[i++]) << 8);
-						//Read 3rd and 4th bytes
-						if(fieldDescriptor & 0x1000)
+						particles[newIndex].tmp = partsData[i++];
+						//Read 2nd byte
+						if(fieldDescriptor & 0x10)
 						{
-							if (i+1 >= partsDataLen)
+							if (i >= partsDataLen)
 								throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading tmp");
-							particles[newIndex].tmp |= (((unsigned)partsData[i++]) << 24);
-							particles[newIndex].tmp |= (((unsigned)partsData[i++]) << 16);
+							particles[newIndex].tmp |= (((unsigned)partsData[i++]) << 8);
+							//Read 3rd and 4th bytes
+							if(fieldDescriptor & 0x1000)
+							{
+								if (i+1 >= partsDataLen)
+									throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading tmp");
+								particles[newIndex].tmp |= (((unsigned)partsData[i++]) << 24);
+								particles[newIndex].tmp |= (((unsigned)partsData[i++]) << 16);
+							}
 						}
 					}
-				}
 
-				//Read ctype
-				if(fieldDescriptor & 0x20)
-				{
-					if (i >= partsDataLen)
-						throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading ctype");
-					particles[newIndex].ctype = partsData[i++];
-					//Read additional bytes
-					if(fieldDescriptor & 0x200)
+					//Read ctype
+					if(fieldDescriptor & 0x20)
 					{
-						if (i+2 >= partsDataLen)
+						if (i >= partsDataLen)
 							throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading ctype");
-						particles[newIndex].ctype |= (((unsigned)partsData[i++]) << 24);
-						particles[newIndex].ctype |= (((unsigned)partsData[i++]) << 16);
-						particles[newIndex].ctype |= (((unsigned)partsData[i++]) << 8);
+						particles[newIndex].ctype = partsData[i++];
+						//Read additional bytes
+						if(fieldDescriptor & 0x200)
+						{
+							if (i+2 >= partsDataLen)
+								throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading ctype");
+							particles[newIndex].ctype |= (((unsigned)partsData[i++]) << 24);
+							particles[newIndex].ctype |= (((unsigned)partsData[i++]) << 16);
+							particles[newIndex].ctype |= (((unsigned)partsData[i++]) << 8);
+						}
 					}
-				}
-
-				//Read dcolour
-				if(fieldDescriptor & 0x40)
-				{
-					if (i+3 >= partsDataLen)
-						throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading deco");
-					particles[newIndex].dcolour = (((unsigned)partsData[i++]) << 24);
-					particles[newIndex].dcolour |= (((unsigned)partsData[i++]) << 16);
-					particles[newIndex].dcolour |= (((unsigned)partsData[i++]) << 8);
-					particles[newIndex].dcolour |= ((unsigned)partsData[i++]);
-				}
-
-				//Read vx
-				if(fieldDescriptor & 0x80)
-				{
-					if (i >= partsDataLen)
-						throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading vx");
-					particles[newIndex].vx = (partsData[i++]-127.0f)/16.0f;
-				}
 
-				//Read vy
-				if(fieldDescriptor & 0x100)
-				{
-					if (i >= partsDataLen)
-						throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading vy");
-					particles[newIndex].vy = (partsData[i++]-127.0f)/16.0f;
-				}
-
-				//Read tmp2
-				if(fieldDescriptor & 0x400)
-				{
-					if (i >= partsDataLen)
-						throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading tmp2");
-					particles[newIndex].tmp2 = partsData[i++];
-					if(fieldDescriptor & 0x800)
+					//Read dcolour
+					if(fieldDescriptor & 0x40)
 					{
-						if (i >= partsDataLen)
-							throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading tmp2");
-						particles[newIndex].tmp2 |= (((unsigned)partsData[i++]) << 8);
+						if (i+3 >= partsDataLen)
+							throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading deco");
+						particles[newIndex].dcolour = (((unsigned)partsData[i++]) << 24);
+						particles[newIndex].dcolour |= (((unsigned)partsData[i++]) << 16);
+						particles[newIndex].dcolour |= (((unsigned)partsData[i++]) << 8);
+						particles[newIndex].dcolour |= ((unsigned)partsData[i++]);
 					}
-				}
 
-				//Read tmp3 and tmp4
-				if(fieldDescriptor & 0x2000)
-				{
-					if (i+3 >= partsDataLen)
-						throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading tmp3 and tmp4");
-					if (fieldDescriptor & 0x10000 && i+7 >= partsDataLen)
-						throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading high halves of tmp3 and tmp4");
-					unsigned int tmp34;
-					tmp34  = (unsigned int)partsData[i + 0];
-					tmp34 |= (unsigned int)partsData[i + 1] << 8;
-					if (fieldDescriptor & 0x10000)
+					//Read vx
+					if(fieldDescriptor & 0x80)
 					{
-						tmp34 |= (unsigned int)partsData[i + 4] << 16;
-						tmp34 |= (unsigned int)partsData[i + 5] << 24;
-					}
-					particles[newIndex].tmp3 = int(tmp34);
-					tmp34  = (unsigned int)partsData[i + 2];
-					tmp34 |= (unsigned int)partsData[i + 3] << 8;
-					if (fieldDescriptor & 0x10000)
-					{
-						tmp34 |= (unsigned int)partsData[i + 6] << 16;
-						tmp34 |= (unsigned int)partsData[i + 7] << 24;
+						if (i >= partsDataLen)
+							throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading vx");
+						particles[newIndex].vx = (partsData[i++]-127.0f)/16.0f;
 					}
-					particles[newIndex].tmp4 = int(tmp34);
-					i += 4;
-					if (fieldDescriptor & 0x10000)
-						i += 4;
-				}
 
-				//Particle specific parsing:
-				switch(particles[newIndex].type)
-				{
-				case PT_SOAP:
-					//Clear soap links, links will be added back in if soapLinkData is present
-					particles[newIndex].ctype &= ~6;
-					break;
-				case PT_BOMB:
-					if (particles[newIndex].tmp!=0 && savedVersion < 81)
-					{
-						particles[newIndex].type = PT_EMBR;
-						particles[newIndex].ctype = 0;
-						if (particles[newIndex].tmp==1)
-							particles[newIndex].tmp = 0;
-					}
-					break;
-				case PT_DUST:
-					if (particles[newIndex].life>0 && savedVersion < 81)
-					{
-						particles[newIndex].type = PT_EMBR;
-						particles[newIndex].ctype = (particles[newIndex].tmp2<<16) | (particles[newIndex].tmp<<8) | particles[newIndex].ctype;
-						particles[newIndex].tmp = 1;
-					}
-					break;
-				case PT_FIRW:
-					if (particles[newIndex].tmp>=2 && savedVersion < 81)
-					{
-						particles[newIndex].type = PT_EMBR;
-						particles[newIndex].ctype = Renderer::firwTableAt(particles[newIndex].tmp - 4).Pack();
-						particles[newIndex].tmp = 1;
-					}
-					break;
-				case PT_PSTN:
-					if (savedVersion < 87 && particles[newIndex].ctype)
-						particles[newIndex].life = 1;
-					if (savedVersion < 91)
-						particles[newIndex].temp = 283.15f;
-					break;
-				case PT_FILT:
-					if (savedVersion < 89)
-					{
-						if (particles[newIndex].tmp<0 || particles[newIndex].tmp>3)
-							particles[newIndex].tmp = 6;
-						particles[newIndex].ctype = 0;
-					}
-					break;
-				case PT_QRTZ:
-				case PT_PQRT:
-					if (savedVersion < 89)
-					{
-						particles[newIndex].tmp2 = particles[newIndex].tmp;
-						particles[newIndex].tmp = particles[newIndex].ctype;
-						particles[newIndex].ctype = 0;
-					}
-					break;
-				case PT_PHOT:
-					if (savedVersion < 90)
+					//Read vy
+					if(fieldDescriptor & 0x100)
 					{
-						particles[newIndex].flags |= FLAG_PHOTDECO;
-					}
-					break;
-				case PT_VINE:
-					if (savedVersion < 91)
-					{
-						particles[newIndex].tmp = 1;
-					}
-					break;
-				case PT_DLAY:
-					// correct DLAY temperature in older saves
-					// due to either the +.5f now done in DLAY (higher temps), or rounding errors in the old DLAY code (room temperature temps),
-					// the delay in all DLAY from older versions will always be one greater than it should
-					if (savedVersion < 91)
-					{
-						particles[newIndex].temp = particles[newIndex].temp - 1.0f;
+						if (i >= partsDataLen)
+							throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading vy");
+						particles[newIndex].vy = (partsData[i++]-127.0f)/16.0f;
 					}
-					break;
-				case PT_CRAY:
-					if (savedVersion < 91)
+
+					//Read tmp2
+					if(fieldDescriptor & 0x400)
 					{
-						if (particles[newIndex].tmp2)
+						if (i >= partsDataLen)
+							throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading tmp2");
+						particles[newIndex].tmp2 = partsData[i++];
+						if(fieldDescriptor & 0x800)
 						{
-							particles[newIndex].ctype |= particles[newIndex].tmp2<<8;
-							particles[newIndex].tmp2 = 0;
+							if (i >= partsDataLen)
+								throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading tmp2");
+							particles[newIndex].tmp2 |= (((unsigned)partsData[i++]) << 8);
 						}
 					}
-					break;
-				case PT_CONV:
-					if (savedVersion < 91)
+
+					//Read tmp3 and tmp4
+					if(fieldDescriptor & 0x2000)
 					{
-						if (particles[newIndex].tmp)
+						if (i+3 >= partsDataLen)
+							throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading tmp3 and tmp4");
+						if (fieldDescriptor & 0x10000 && i+7 >= partsDataLen)
+							throw ParseException(ParseException::Corrupt, "Ran past particle data buffer while loading high halves of tmp3 and tmp4");
+						unsigned int tmp34;
+						tmp34  = (unsigned int)partsData[i + 0];
+						tmp34 |= (unsigned int)partsData[i + 1] << 8;
+						if (fieldDescriptor & 0x10000)
 						{
-							particles[newIndex].ctype |= particles[newIndex].tmp<<8;
-							particles[newIndex].tmp = 0;
+							tmp34 |= (unsigned int)partsData[i + 4] << 16;
+							tmp34 |= (unsigned int)partsData[i + 5] << 24;
 						}
+						particles[newIndex].tmp3 = int(tmp34);
+						tmp34  = (unsigned int)partsData[i + 2];
+						tmp34 |= (unsigned int)partsData[i + 3] << 8;
+						if (fieldDescriptor & 0x10000)
+						{
+							tmp34 |= (unsigned int)partsData[i + 6] << 16;
+							tmp34 |= (unsigned int)partsData[i + 7] << 24;
+						}
+						particles[newIndex].tmp4 = int(tmp34);
+						i += 4;
+						if (fieldDescriptor & 0x10000)
+							i += 4;
 					}
-					break;
-				case PT_PIPE:
-				case PT_PPIP:
-					if (savedVersion < 93 && !fakeNewerVersion)
-					{
-						if (particles[newIndex].ctype == 1)
-							particles[newIndex].tmp |= 0x00020000; //PFLAG_INITIALIZING
-						particles[newIndex].tmp |= (particles[newIndex].ctype-1)<<18;
-						particles[newIndex].ctype = particles[newIndex].tmp&0xFF;
-					}
-					break;
-				case PT_TSNS:
-				case PT_HSWC:
-				case PT_PSNS:
-				case PT_PUMP:
-					if (savedVersion < 93 && !fakeNewerVersion)
-					{
-						particles[newIndex].tmp = 0;
-					}
-					break;
-				case PT_LIFE:
-					if (savedVersion < 96 && !fakeNewerVersion)
+
+					//Particle specific parsing:
+					switch(particles[newIndex].type)
 					{
-						if (particles[newIndex].ctype >= 0 && particles[newIndex].ctype < NGOL)
+					case PT_SOAP:
+						//Clear soap links, links will be added back in if soapLinkData is present
+						particles[newIndex].ctype &= ~6;
+						break;
+					case PT_BOMB:
+						if (particles[newIndex].tmp!=0 && savedVersion < 81)
+						{
+							particles[newIndex].type = PT_EMBR;
+							particles[newIndex].ctype = 0;
+							if (particles[newIndex].tmp==1)
+								particles[newIndex].tmp = 0;
+						}
+						break;
+					case PT_DUST:
+						if (particles[newIndex].life>0 && savedVersion < 81)
+						{
+							particles[newIndex].type = PT_EMBR;
+							particles[newIndex].ctype = (particles[newIndex].tmp2<<16) | (particles[newIndex].tmp<<8) | particles[newIndex].ctype;
+							particles[newIndex].tmp = 1;
+						}
+						break;
+					case PT_FIRW:
+						if (particles[newIndex].tmp>=2 && savedVersion < 81)
+						{
+							particles[newIndex].type = PT_EMBR;
+							particles[newIndex].ctype = Renderer::firwTableAt(particles[newIndex].tmp - 4).Pack();
+							particles[newIndex].tmp = 1;
+						}
+						break;
+					case PT_PSTN:
+						if (savedVersion < 87 && particles[newIndex].ctype)
+							particles[newIndex].life = 1;
+						if (savedVersion < 91)
+							particles[newIndex].temp = 283.15f;
+						break;
+					case PT_FILT:
+						if (savedVersion < 89)
+						{
+							if (particles[newIndex].tmp<0 || particles[newIndex].tmp>3)
+								particles[newIndex].tmp = 6;
+							particles[newIndex].ctype = 0;
+						}
+						break;
+					case PT_QRTZ:
+					case PT_PQRT:
+						if (savedVersion < 89)
 						{
 							particles[newIndex].tmp2 = particles[newIndex].tmp;
-							if (!particles[newIndex].dcolour)
-								particles[newIndex].dcolour = builtinGol[particles[newIndex].ctype].colour.Pack();
-							particles[newIndex].tmp = builtinGol[particles[newIndex].ctype].colour2.Pack();
+							particles[newIndex].tmp = particles[newIndex].ctype;
+							particles[newIndex].ctype = 0;
+						}
+						break;
+					case PT_PHOT:
+						if (savedVersion < 90)
+						{
+							particles[newIndex].flags |= FLAG_PHOTDECO;
+						}
+						break;
+					case PT_VINE:
+						if (savedVersion < 91)
+						{
+							particles[newIndex].tmp = 1;
+						}
+						break;
+					case PT_DLAY:
+						// correct DLAY temperature in older saves
+						// due to either the +.5f now done in DLAY (higher temps), or rounding errors in the old DLAY code (room temperature temps),
+						// the delay in all DLAY from older versions will always be one greater than it should
+						if (savedVersion < 91)
+						{
+							particles[newIndex].temp = particles[newIndex].temp - 1.0f;
+						}
+						break;
+					case PT_CRAY:
+						if (savedVersion < 91)
+						{
+							if (particles[newIndex].tmp2)
+							{
+								particles[newIndex].ctype |= particles[newIndex].tmp2<<8;
+								particles[newIndex].tmp2 = 0;
+							}
+						}
+						break;
+					case PT_CONV:
+						if (savedVersion < 91)
+						{
+							if (particles[newIndex].tmp)
+							{
+								particles[newIndex].ctype |= particles[newIndex].tmp<<8;
+								particles[newIndex].tmp = 0;
+							}
+						}
+						break;
+					case PT_PIPE:
+					case PT_PPIP:
+						if (savedVersion < 93 && !fakeNewerVersion)
+						{
+							if (particles[newIndex].ctype == 1)
+								particles[newIndex].tmp |= 0x00020000; //PFLAG_INITIALIZING
+							particles[newIndex].tmp |= (particles[newIndex].ctype-1)<<18;
+							particles[newIndex].ctype = particles[newIndex].tmp&0xFF;
+						}
+						break;
+					case PT_TSNS:
+					case PT_HSWC:
+					case PT_PSNS:
+					case PT_PUMP:
+						if (savedVersion < 93 && !fakeNewerVersion)
+						{
+							particles[newIndex].tmp = 0;
+						}
+						break;
+					case PT_LIFE:
+						if (savedVersion < 96 && !fakeNewerVersion)
+						{
+							if (particles[newIndex].ctype >= 0 && particles[newIndex].ctype < NGOL)
+							{
+								particles[newIndex].tmp2 = particles[newIndex].tmp;
+								if (!particles[newIndex].dcolour)
+									particles[newIndex].dcolour = builtinGol[particles[newIndex].ctype].colour.Pack();
+								particles[newIndex].tmp = builtinGol[particles[newIndex].ctype].colour2.Pack();
+							}
 						}
 					}
-				}
-				if (PressureInTmp3(particles[newIndex].type))
-				{
-					// pavg[1] used to be saved as a u16, which PressureInTmp3 elements then treated as
-					// an i16. tmp3 is now saved as a u32, or as a u16 if it's small enough. PressureInTmp3
-					// elements will never use the upper 16 bits, and should still treat the lower 16 bits
-					// as an i16, so they need sign extension.
-					auto tmp3 = (unsigned int)(particles[newIndex].tmp3);
-					if (tmp3 & 0x8000U)
+					if (PressureInTmp3(particles[newIndex].type))
 					{
-						tmp3 |= 0xFFFF0000U;
-						particles[newIndex].tmp3 = int(tmp3);
+						// pavg[1] used to be saved as a u16, which PressureInTmp3 elements then treated as
+						// an i16. tmp3 is now saved as a u32, or as a u16 if it's small enough. PressureInTmp3
+						// elements will never use the upper 16 bits, and should still treat the lower 16 bits
+						// as an i16, so they need sign extension.
+						auto tmp3 = (unsigned int)(particles[newIndex].tmp3);
+						if (tmp3 & 0x8000U)
+						{
+							tmp3 |= 0xFFFF0000U;
+							particles[newIndex].tmp3 = int(tmp3);
+						}
 					}
+					//note: PSv was used in version 77.0 and every version before, add something in PSv too if the element is that old
+					newIndex++;
+					partsCount++;
 				}
-				//note: PSv was used in version 77.0 and every version before, add something in PSv too if the element is that old
-				newIndex++;
-				partsCount++;
 			}
+
+			if (i != partsDataLen)
+				throw ParseException(ParseException::Corrupt, "Didn't reach end of particle data buffer");
 		}
+	};
 
-		if (i != partsDataLen)
-			throw ParseException(ParseException::Corrupt, "Didn't reach end of particle data buffer");
-	}
+	runConcurrently({ readWalls, readAir, readParticles });
 
 	if (soapLinkData)
 	{
@@ -1903,7 +1973,7 @@ void GameSave::readPSv(const std::vector<char> &dataVec)
 #undef MTOS
 #undef MTOS_EXPAND
 
-std::pair<bool, std::vector<char>> GameSave::serialiseOPS() const
+std::pair<bool, std::vector<char>> GameSave::serialiseOPS(Compression compression) const
 {
 	// minimum version this save is compatible with
 	// when building, this number may be increased depending on what elements are used
@@ -2558,11 +2628,23 @@ std::pair<bool, std::vector<char>> GameSave::serialiseOPS() const
 
 
 	std::vector<char> outputData;
-	switch (auto status = BZ2WCompress(outputData, (char *)finalData, finalDataLen))
+	if (compression == compressionZlib)
 	{
-	case BZ2WCompressOk: break;
-	case BZ2WCompressNomem: throw BuildException(String::Build("Save error, out of memory"));
-	default: throw BuildException(String::Build("Cannot compress: status ", int(status)));
+		switch (auto status = ZlibWCompress(outputData, (char *)finalData, finalDataLen))
+		{
+		case ZlibWCompressOk: break;
+		case ZlibWCompressNomem: throw BuildException(String::Build("Save error, out of memory"));
+		default: throw BuildException(String::Build("Cannot compress: status ", int(status)));
+		}
+	}
+	else
+	{
+		switch (auto status = BZ2WCompress(outputData, (char *)finalData, finalDataLen))
+		{
+		case BZ2WCompressOk: break;
+		case BZ2WCompressNomem: throw BuildException(String::Build("Save error, out of memory"));
+		default: throw BuildException(String::Build("Cannot compress: status ", int(status)));
+		}
 	}
 	auto compressedSize = int(outputData.size());
 
@@ -2576,7 +2658,7 @@ std::pair<bool, std::vector<char>> GameSave::serialiseOPS() const
 	header[0] = 'O';
 	header[1] = 'P';
 	header[2] = 'S';
-	header[3] = '1';
+	header[3] = compression == compressionZlib ? 'Z' : '1';
 	header[4] = effectiveVersion[0];
 	header[5] = CELL;
 	header[6] = blockS.X;
@@ -58,10 +58,21 @@ public:
 
 class GameSave
 {
+public:
+	// How the OPS payload is compressed. Only bzip2 is understood by the server
+	// and by older versions; zlib is much faster, so it is used for stamps and
+	// other data that does not leave this machine. Both are read transparently.
+	enum Compression
+	{
+		compressionBzip2,
+		compressionZlib,
+	};
+
+private:
 	// number of pixels translated. When translating CELL pixels, shift all CELL grids
 	void readOPS(const std::vector<char> &data);
 	void readPSv(const std::vector<char> &data);
-	std::pair<bool, std::vector<char>> serialiseOPS() const;
+	std::pair<bool, std::vector<char>> serialiseOPS(Compression compression) const;
 
 	void MapPalette();
 
@@ -123,7 +134,7 @@ public:
 	GameSave(const std::vector<char> &data, bool newWantAuthors = true);
 	void setSize(Vec2<int> newBlockSize);
 	// return value is [ fakeFromNewerVersion, gameData ]
-	std::pair<bool, std::vector<char>> Serialise() const;
+	std::pair<bool, std::vector<char>> Serialise(Compression compression = compressionBzip2) const;
 	void Transform(Mat2<int> transform, Vec2<int> nudge);
 
 	void Expand(const std::vector<char> &data);
@@ -0,0 +1,169 @@
+#include "SaveWriter.h"
+#include "common/platform/Platform.h"
+#include "simulation/SimulationData.h"
+#include "tasks/AbandonableTask.h"
+#include <iostream>
+
+namespace
+{
+	class SaveWriteTask : public AbandonableTask
+	{
+		SaveWriter::Job job;
+		std::shared_ptr<SaveWriter::Result> result;
+
+		bool doWork() override
+		{
+			if (job.backup && Platform::FileExists(job.path))
+			{
+				std::vector<char> data;
+				if (!Platform::ReadFile(data, job.path) || !Platform::WriteFile(data, job.path + ".backup"))
+				{
+					result->backupFailed = true;
+				}
+			}
+			std::vector<char> data;
+			try
+			{
+				// Serialising reads element identifiers, which Lua may change on the main thread
+				std::shared_lock lk(SimulationData::CRef().elementGraphicsMx);
+				std::tie(std::ignore, data) = job.save->Serialise(job.compression);
+			}
+			catch (const std::exception &e)
+			{
+				result->error = "Unable to serialize game data: " + ByteString(e.what()).FromUtf8();
+				return false;
+			}
+			job.save.reset();
+			if (!data.size())
+			{
+				result->error = "Unable to serialize game data.";
+				return false;
+			}
+			if (!Platform::WriteFile(data, job.path))
+			{
+				result->error = "Unable to write save file.";
+				return false;
+			}
+			return true;
+		}
+
+	public:
+		SaveWriteTask(SaveWriter::Job newJob, std::shared_ptr<SaveWriter::Result> newResult) : job(std::move(newJob)), result(newResult)
+		{
+		}
+	};
+}
+
+SaveWriter::~SaveWriter()
+{
+	Finish();
+}
+
+std::map<ByteString, SaveWriter::Queue>::iterator SaveWriter::StartNext(std::map<ByteString, Queue>::iterator it, std::vector<Finished> &finished)
+{
+	auto &queue = it->second;
+	if (queue.task)
+	{
+		// Waits for the task if it has not finished yet
+		queue.task->Finish();
+		queue.task = nullptr;
+		finished.push_back({ it->first, std::move(queue.onDone), std::move(queue.result) });
+	}
+	if (queue.jobs.empty())
+	{
+		return queues.erase(it);
+	}
+	auto job = std::move(queue.jobs.front());
+	queue.jobs.pop_front();
+	queue.onDone = std::move(job.onDone);
+	queue.result = std::make_shared<Result>();
+	queue.task = new SaveWriteTask(std::move(job), queue.result);
+	queue.task->Start();
+	return std::next(it);
+}
+
+void SaveWriter::Notify(std::vector<Finished> &finished)
+{
+	for (auto &item : finished)
+	{
+		if (item.onDone)
+		{
+			item.onDone(*item.result);
+		}
+	}
+}
+
+void SaveWriter::Write(Job job)
+{
+	auto it = queues.emplace(job.path, Queue{}).first;
+	it->second.jobs.push_back(std::move(job));
+	if (!it->second.task)
+	{
+		std::vector<Finished> finished;
+		StartNext(it, finished);
+	}
+}
+
+void SaveWriter::Tick()
+{
+	std::vector<Finished> finished;
+	for (auto it = queues.begin(); it != queues.end(); )
+	{
+		it->second.task->Poll();
+		if (it->second.task->GetDone())
+		{
+			it = StartNext(it, finished);
+		}
+		else
+		{
+			++it;
+		}
+	}
+	Notify(finished);
+}
+
+void SaveWriter::Flush(const ByteString &path)
+{
+	std::vector<Finished> finished;
+	for (auto it = queues.find(path); it != queues.end(); it = queues.find(path))
+	{
+		StartNext(it, finished);
+	}
+	Notify(finished);
+}
+
+void SaveWriter::Flush()
+{
+	std::vector<Finished> finished;
+	while (!queues.empty())
+	{
+		for (auto it = queues.begin(); it != queues.end(); )
+		{
+			it = StartNext(it, finished);
+		}
+	}
+	Notify(finished);
+}
+
+void SaveWriter::Finish()
+{
+	std::vector<Finished> finished;
+	while (!queues.empty())
+	{
+		for (auto it = queues.begin(); it != queues.end(); )
+		{
+			it = StartNext(it, finished);
+		}
+	}
+	for (auto &item : finished)
+	{
+		if (item.result->backupFailed)
+		{
+			std::cerr << "SaveWriter: " << item.path << ": unable to make backup" << std::endl;
+		}
+		if (item.result->error.size())
+		{
+			std::cerr << "SaveWriter: " << item.path << ": " << item.result->error.ToUtf8() << std::endl;
+		}
+	}
+}
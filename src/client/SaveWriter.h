@@ -0,0 +1,69 @@
+#pragma once
+#include "common/String.h"
+#include "client/GameSave.h"
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+
+class AbandonableTask;
+
+// Serialises saves and writes them to disk on the task pool, so that the
+// caller only has to pay for taking a snapshot of the simulation. Writes to
+// the same path happen in the order in which they were queued; anything
+// that wants to read or remove a file with writes still pending should
+// Flush it first.
+class SaveWriter
+{
+public:
+	struct Result
+	{
+		bool backupFailed = false;
+		// Empty if the save was written
+		String error;
+	};
+	using OnDone = std::function<void (const Result &)>;
+
+	struct Job
+	{
+		ByteString path;
+		std::unique_ptr<GameSave> save;
+		GameSave::Compression compression = GameSave::compressionBzip2;
+		// Copy whatever is at path to path + ".backup" before overwriting it
+		bool backup = false;
+		// Called from Tick or Flush on the main thread
+		OnDone onDone;
+	};
+
+private:
+	struct Queue
+	{
+		AbandonableTask *task = nullptr;
+		std::shared_ptr<Result> result;
+		OnDone onDone;
+		std::deque<Job> jobs;
+	};
+	std::map<ByteString, Queue> queues;
+
+	struct Finished
+	{
+		ByteString path;
+		OnDone onDone;
+		std::shared_ptr<Result> result;
+	};
+	std::map<ByteString, Queue>::iterator StartNext(std::map<ByteString, Queue>::iterator it, std::vector<Finished> &finished);
+	static void Notify(std::vector<Finished> &finished);
+
+public:
+	~SaveWriter();
+
+	void Write(Job job);
+	void Tick();
+	// Waits for all writes to path queued so far.
+	void Flush(const ByteString &path);
+	// Waits for all writes queued so far.
+	void Flush();
+	// Same as Flush, but without calling back, for when whatever the callbacks
+	// refer to may already be gone. Failures are reported on stderr instead.
+	void Finish();
+};
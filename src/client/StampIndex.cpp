@@ -0,0 +1,371 @@
+#include "StampIndex.h"
+#include "common/platform/Platform.h"
+#include "prefs/Prefs.h"
+#include "Config.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+constexpr char stampExtension[] = ".stm";
+constexpr char journalName[] = "stamps.journal";
+constexpr char journalMagic[] = "TPTSTAMPS1";
+// The journal is folded back into stamps.json once it has this many entries
+constexpr int compactInterval = 256;
+// Milliseconds between checks for changes made to the directory by something else
+constexpr unsigned long pollInterval = 2000;
+
+StampIndex::StampIndex(ByteString newDir) : dir(newDir)
+{
+}
+
+StampIndex::~StampIndex()
+{
+	// Lets the next session skip listing the directory if nothing touches it in the meantime
+	if (prefs && listedModified && Fresh() && Platform::FileExists(Path(journalName)))
+	{
+		Append(ByteString::Build("@", *listedModified));
+	}
+}
+
+ByteString StampIndex::Path(const ByteString &name) const
+{
+	return ByteString::Build(dir, PATH_SEP_CHAR, name);
+}
+
+ByteString StampIndex::StampPath(const ByteString &id) const
+{
+	return ByteString::Build(dir, PATH_SEP_CHAR, id, stampExtension);
+}
+
+void StampIndex::MigrateStampsDef()
+{
+	std::vector<char> data;
+	if (!Platform::ReadFile(data, Path("stamps.def")))
+	{
+		return;
+	}
+	for (auto i = 0; i + 10 <= int(data.size()); i += 10)
+	{
+		ByteString id(&data[0] + i, &data[0] + i + 10);
+		if (idSet.insert(id).second)
+		{
+			ids.push_back(id);
+		}
+	}
+}
+
+void StampIndex::Load()
+{
+	prefs = std::make_unique<Prefs>(Path("stamps.json"));
+	for (auto &id : prefs->Get("MostRecentlyUsedFirst", std::vector<ByteString>{}))
+	{
+		if (idSet.insert(id).second)
+		{
+			ids.push_back(id);
+		}
+	}
+	if (!prefs->BackedByFile())
+	{
+		MigrateStampsDef();
+	}
+	std::optional<int64_t> recordedModified;
+	if (!ReplayJournal(recordedModified))
+	{
+		// Either there is no journal or stamps.json was written by something
+		// that does not know about it; in both cases stamps.json is all there is
+		// to go by, and the journal has to be started afresh
+		journalEntries = compactInterval;
+	}
+	if (recordedModified && recordedModified == Platform::GetDirectoryModified(dir))
+	{
+		listedModified = recordedModified;
+	}
+	else
+	{
+		Rescan();
+	}
+	if (journalEntries >= compactInterval)
+	{
+		Compact();
+	}
+}
+
+bool StampIndex::ReplayJournal(std::optional<int64_t> &recordedModified)
+{
+	auto path = Path(journalName);
+	auto info = Platform::GetFileInfo(Path("stamps.json"));
+	std::vector<char> data;
+	if (!info || !Platform::FileExists(path) || !Platform::ReadFile(data, path))
+	{
+		return false;
+	}
+	auto header = ByteString::Build(journalMagic, " ", info->size, " ", info->modified);
+	auto headerSeen = false;
+	auto it = data.begin();
+	while (true)
+	{
+		auto end = std::find(it, data.end(), '\n');
+		if (end == data.end())
+		{
+			// Either the end of the journal, or an entry that was cut short
+			break;
+		}
+		ByteString line(it, end);
+		it = end + 1;
+		if (!headerSeen)
+		{
+			if (line != header)
+			{
+				return false;
+			}
+			headerSeen = true;
+			continue;
+		}
+		if (!line.size())
+		{
+			continue;
+		}
+		ByteString arg(line.begin() + 1, line.end());
+		switch (line[0])
+		{
+		case '+':
+			Front(arg);
+			break;
+
+		case '-':
+			Erase(arg);
+			break;
+
+		case '=':
+			if (auto split = arg.SplitBy('\t'))
+			{
+				Replace(split.Before(), split.After());
+			}
+			break;
+
+		case '@':
+			recordedModified = arg.ToNumber<int64_t>(true);
+			break;
+		}
+		journalEntries += 1;
+	}
+	return headerSeen;
+}
+
+void StampIndex::Append(ByteString entry)
+{
+	auto path = Path(journalName);
+	if (entry.Contains('\n') || journalEntries + 1 >= compactInterval || !Platform::FileExists(path))
+	{
+		Compact();
+		return;
+	}
+	std::ofstream f(path, std::ios::binary | std::ios::app);
+	f << entry << '\n';
+	if (!f)
+	{
+		std::cerr << "StampIndex: failed to append to " << path << std::endl;
+		return;
+	}
+	journalEntries += 1;
+}
+
+void StampIndex::Compact()
+{
+	journalEntries = 0;
+	if (!Platform::DirectoryExists(dir))
+	{
+		return;
+	}
+	auto fresh = Fresh();
+	prefs->Set("MostRecentlyUsedFirst", ids);
+	auto info = Platform::GetFileInfo(Path("stamps.json"));
+	if (!info)
+	{
+		return;
+	}
+	// The header ties the journal to this particular stamps.json, so that the
+	// journal is ignored if something else writes stamps.json later
+	auto header = ByteString::Build(journalMagic, " ", info->size, " ", info->modified, "\n");
+	Platform::WriteFile(std::vector<char>(header.begin(), header.end()), Path(journalName));
+	Touched(fresh);
+}
+
+bool StampIndex::Fresh() const
+{
+	return Platform::GetDirectoryModified(dir) == listedModified;
+}
+
+void StampIndex::Touched(bool fresh)
+{
+	if (fresh)
+	{
+		listedModified = Platform::GetDirectoryModified(dir);
+	}
+}
+
+void StampIndex::Front(const ByteString &id)
+{
+	if (idSet.insert(id).second)
+	{
+		ids.insert(ids.begin(), id);
+		return;
+	}
+	auto it = std::find(ids.begin(), ids.end(), id);
+	std::rotate(ids.begin(), it, it + 1);
+}
+
+void StampIndex::Erase(const ByteString &id)
+{
+	if (idSet.erase(id))
+	{
+		ids.erase(std::find(ids.begin(), ids.end(), id));
+	}
+}
+
+bool StampIndex::Replace(const ByteString &id, const ByteString &newID)
+{
+	if (!Contains(id))
+	{
+		return false;
+	}
+	Erase(newID);
+	idSet.erase(id);
+	idSet.insert(newID);
+	*std::find(ids.begin(), ids.end(), id) = newID;
+	return true;
+}
+
+void StampIndex::Rescan()
+{
+	// Taken before listing so that anything that changes the directory while
+	// it is being listed is picked up by the next Poll
+	listedModified = Platform::GetDirectoryModified(dir);
+	ByteString extension = stampExtension;
+	std::unordered_set<ByteString, std::hash<std::string>> found;
+	for (auto &name : Platform::DirectorySearch(dir, "", { extension }))
+	{
+		found.insert(name.substr(0, name.size() - extension.size()));
+	}
+	found.insert(pendingIDs.begin(), pendingIDs.end());
+	std::vector<ByteString> newIDs;
+	auto changed = false;
+	for (auto &id : ids)
+	{
+		if (found.find(id) == found.end())
+		{
+			changed = true;
+		}
+		else
+		{
+			newIDs.push_back(id);
+		}
+	}
+	std::vector<ByteString> unknownIDs;
+	for (auto &id : found)
+	{
+		if (!Contains(id))
+		{
+			unknownIDs.push_back(id);
+		}
+	}
+	if (unknownIDs.size())
+	{
+		std::sort(unknownIDs.begin(), unknownIDs.end());
+		newIDs.insert(newIDs.end(), unknownIDs.begin(), unknownIDs.end());
+		changed = true;
+	}
+	if (changed)
+	{
+		ids = std::move(newIDs);
+		idSet = decltype(idSet)(ids.begin(), ids.end());
+		Compact();
+	}
+}
+
+void StampIndex::Poll()
+{
+	auto now = Platform::GetTime();
+	if (now - lastPoll < pollInterval || pendingIDs.size())
+	{
+		return;
+	}
+	lastPoll = now;
+	if (!Fresh())
+	{
+		Rescan();
+	}
+}
+
+void StampIndex::BeginAdd(ByteString id)
+{
+	if (pendingIDs.empty())
+	{
+		freshBeforePending = Fresh();
+	}
+	pendingIDs.insert(id);
+	Platform::MakeDirectory(dir);
+	Front(id);
+	Append("+" + id);
+}
+
+void StampIndex::EndAdd(ByteString id, bool written)
+{
+	pendingIDs.erase(id);
+	if (!written)
+	{
+		Erase(id);
+		Append("-" + id);
+	}
+	if (pendingIDs.empty())
+	{
+		Touched(freshBeforePending);
+	}
+}
+
+void StampIndex::Remove(ByteString id)
+{
+	if (!Contains(id))
+	{
+		return;
+	}
+	auto fresh = Fresh();
+	Erase(id);
+	Platform::RemoveFile(StampPath(id));
+	Append("-" + id);
+	Touched(fresh);
+}
+
+bool StampIndex::Rename(ByteString id, ByteString newID)
+{
+	auto fresh = Fresh();
+	if (!Platform::RenameFile(StampPath(id), StampPath(newID), false))
+	{
+		return false;
+	}
+	if (!Replace(id, newID))
+	{
+		// Not a stamp the index knows about; leave it to the next Poll to find
+		return true;
+	}
+	if (id.Contains('\t') || newID.Contains('\t'))
+	{
+		Compact();
+	}
+	else
+	{
+		Append(ByteString::Build("=", id, "\t", newID));
+	}
+	Touched(fresh);
+	return true;
+}
+
+void StampIndex::MoveToFront(ByteString id)
+{
+	if (ids.size() && ids.front() == id)
+	{
+		return;
+	}
+	Front(id);
+	Append("+" + id);
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "common/String.h"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+class Prefs;
+
+// Keeps track of the stamps in a directory, most recently used first. The
+// order is stored in stamps.json, which is only rewritten every so often;
+// changes made since then are appended to stamps.journal. The directory is
+// only listed again when its modification time says that something other
+// than the index has added, removed or renamed files in it.
+class StampIndex
+{
+	ByteString dir;
+	std::unique_ptr<Prefs> prefs;
+	std::vector<ByteString> ids;
+	std::unordered_set<ByteString, std::hash<std::string>> idSet;
+	// Modification time of dir as of the last time it was listed, or as of
+	// the last change the index made to it, if nothing else touched it in
+	// between.
+	std::optional<int64_t> listedModified;
+	// Stamps whose files are still being written; see BeginAdd
+	std::unordered_set<ByteString, std::hash<std::string>> pendingIDs;
+	bool freshBeforePending = false;
+	int journalEntries = 0;
+	unsigned long lastPoll = 0;
+
+	ByteString Path(const ByteString &name) const;
+	ByteString StampPath(const ByteString &id) const;
+	void MigrateStampsDef();
+	bool ReplayJournal(std::optional<int64_t> &recordedModified);
+	void Append(ByteString entry);
+	void Compact();
+	bool Fresh() const;
+	void Touched(bool fresh);
+	void Front(const ByteString &id);
+	void Erase(const ByteString &id);
+	bool Replace(const ByteString &id, const ByteString &newID);
+
+public:
+	StampIndex(ByteString newDir);
+	~StampIndex();
+
+	void Load();
+	// Lists the directory and reconciles the index with what is found there.
+	void Rescan();
+	// Rescans if something else changed the directory; cheap enough to call every frame.
+	void Poll();
+
+	const std::vector<ByteString> &GetIDs() const
+	{
+		return ids;
+	}
+	bool Contains(const ByteString &id) const
+	{
+		return idSet.find(id) != idSet.end();
+	}
+
+	// The stamp is listed from BeginAdd on, and the caller is expected to have
+	// its file written by the time it calls EndAdd. The directory is not
+	// rescanned by Poll in between.
+	void BeginAdd(ByteString id);
+	void EndAdd(ByteString id, bool written);
+	void Remove(ByteString id);
+	// Does not check whether a stamp called newID already exists.
+	bool Rename(ByteString id, ByteString newID);
+	void MoveToFront(ByteString id);
+};
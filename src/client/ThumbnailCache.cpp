@@ -0,0 +1,56 @@
+#include "ThumbnailCache.h"
+#include "common/CacheFile.h"
+#include "common/platform/Platform.h"
+#include "graphics/Graphics.h"
+#include "Config.h"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+constexpr char cacheMagic[] = "TPTTHUMB1\n";
+constexpr char cacheExtension[] = ".thumb";
+// Pruning lists the whole directory, so it is only done on the first store
+// of a session and after every so many more
+constexpr int pruneInterval = 64;
+
+std::optional<ThumbnailCache::Key> ThumbnailCache::MakeKey(ByteString path, Vec2<int> size, bool decorations, bool fire)
+{
+	auto info = Platform::GetFileInfo(path);
+	if (!info)
+	{
+		return std::nullopt;
+	}
+	// The entry is named after everything but the state of the file, so that a
+	// file that changes replaces its own entry instead of leaving it behind
+	auto name = ByteString::Build(path, " ", size.X, "x", size.Y, decorations ? " decorations" : "", fire ? " fire" : "");
+	Key key;
+	key.entryPath = ByteString::Build(THUMB_CACHE_DIR, PATH_SEP_CHAR, CacheFile::EntryName(name, cacheExtension));
+	key.header = ByteString::Build(cacheMagic, name, " ", info->size, " ", info->modified, "\n");
+	return key;
+}
+
+std::unique_ptr<VideoBuffer> ThumbnailCache::Load(const Key &key)
+{
+	auto data = CacheFile::Read(key.entryPath, key.header);
+	if (!data || !data->size())
+	{
+		return nullptr;
+	}
+	return VideoBuffer::FromPNG(*data);
+}
+
+void ThumbnailCache::Store(const Key &key, const VideoBuffer &thumbnail)
+{
+	auto png = thumbnail.ToPNG();
+	if (!png)
+	{
+		return;
+	}
+	CacheFile::Write(THUMB_CACHE_DIR, key.entryPath, key.header, png->data(), png->size());
+	// Stores happen on any number of task threads at once
+	static std::atomic<int> stores = 0;
+	if (stores++ % pruneInterval == 0)
+	{
+		CacheFile::Prune(THUMB_CACHE_DIR, cacheExtension, thumbCacheMaxBytes);
+	}
+}
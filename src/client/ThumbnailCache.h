@@ -0,0 +1,29 @@
+#pragma once
+#include "common/String.h"
+#include "common/Vec2.h"
+#include <memory>
+#include <optional>
+
+class VideoBuffer;
+
+// Keeps rendered thumbnails of local saves and stamps in THUMB_CACHE_DIR so
+// that browsers need not load and render every file each time they are
+// opened. There is one entry per file and thumbnail kind; it is only used if
+// the size and modification time of the file still match, and is overwritten
+// when the file is rendered again. Once the entries take up more than
+// thumbCacheMaxBytes, those written longest ago are removed. All of this
+// touches the disk, so it is left to ThumbnailRendererTask.
+class ThumbnailCache
+{
+public:
+	struct Key
+	{
+		ByteString entryPath;
+		ByteString header;
+	};
+
+	// Returns nullopt if the file does not exist.
+	static std::optional<Key> MakeKey(ByteString path, Vec2<int> size, bool decorations, bool fire);
+	static std::unique_ptr<VideoBuffer> Load(const Key &key);
+	static void Store(const Key &key, const VideoBuffer &thumbnail);
+};
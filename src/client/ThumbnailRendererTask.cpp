@@ -4,7 +4,10 @@
 
 #include "graphics/Graphics.h"
 #include "simulation/SaveRenderer.h"
+#include "simulation/SimulationData.h"
 #include "client/GameSave.h"
+#include "client/ThumbnailCache.h"
+#include "common/platform/Platform.h"
 
 int ThumbnailRendererTask::queueSize = 0;
 
@@ -19,6 +22,17 @@ ThumbnailRendererTask::ThumbnailRendererTask(GameSave const &save, Vec2<int> siz
 	decorations(decorations),
 	fire(fire)
 {
+	priority = priorityVisible;
+	queueSize += 1;
+}
+
+ThumbnailRendererTask::ThumbnailRendererTask(ByteString path, Vec2<int> size, bool decorations, bool fire):
+	path(path),
+	size(size),
+	decorations(decorations),
+	fire(fire)
+{
+	priority = priorityVisible;
 	queueSize += 1;
 }
 
@@ -27,13 +41,53 @@ ThumbnailRendererTask::~ThumbnailRendererTask()
 	queueSize -= 1;
 }
 
+void ThumbnailRendererTask::UseCache(ByteString newCachePath)
+{
+	cachePath = newCachePath;
+}
+
 bool ThumbnailRendererTask::doWork()
 {
+	std::optional<ThumbnailCache::Key> cacheKey;
+	if (cachePath)
+	{
+		cacheKey = ThumbnailCache::MakeKey(*cachePath, size, decorations, fire);
+		if (cacheKey && (thumbnail = ThumbnailCache::Load(*cacheKey)))
+		{
+			size = thumbnail->Size();
+			return true;
+		}
+	}
+	if (!save)
+	{
+		std::vector<char> data;
+		if (!Platform::ReadFile(data, path))
+		{
+			notifyError("cannot access file");
+			return false;
+		}
+		try
+		{
+			// Parsing maps element identifiers, which Lua may change on the main thread;
+			// the lock is dropped before rendering, which takes it again
+			std::shared_lock lk(SimulationData::CRef().elementGraphicsMx);
+			save = std::make_unique<GameSave>(std::move(data));
+		}
+		catch (const std::exception &e)
+		{
+			notifyError(ByteString(e.what()).FromUtf8());
+			return false;
+		}
+	}
 	thumbnail = SaveRenderer::Ref().Render(save.get(), decorations, fire);
 	if (thumbnail)
 	{
 		thumbnail->ResizeToFit(size, true);
 		size = thumbnail->Size();
+		if (cacheKey)
+		{
+			ThumbnailCache::Store(*cacheKey, *thumbnail);
+		}
 		return true;
 	}
 	else
@@ -42,6 +96,11 @@ bool ThumbnailRendererTask::doWork()
 	}
 }
 
+std::unique_ptr<GameSave> ThumbnailRendererTask::TakeSave()
+{
+	return std::move(save);
+}
+
 std::unique_ptr<VideoBuffer> ThumbnailRendererTask::Finish()
 {
 	auto ptr = std::move(thumbnail);
@@ -1,27 +1,40 @@
 #pragma once
+#include "common/String.h"
 #include "common/Vec2.h"
 #include "tasks/AbandonableTask.h"
 
 #include <memory>
+#include <optional>
 
 class GameSave;
 class VideoBuffer;
 class ThumbnailRendererTask : public AbandonableTask
 {
 	std::unique_ptr<GameSave> save;
+	ByteString path; // save is loaded from here if it is not given
 	Vec2<int> size;
 	bool decorations;
 	bool fire;
+	std::optional<ByteString> cachePath;
 	std::unique_ptr<VideoBuffer> thumbnail;
 
 	static int queueSize;
 
 public:
 	ThumbnailRendererTask(GameSave const &, Vec2<int> size, bool decorations, bool fire);
+	// Reads and parses the save in the background; failures are reported through GetError.
+	ThumbnailRendererTask(ByteString path, Vec2<int> size, bool decorations, bool fire);
 	virtual ~ThumbnailRendererTask();
 
+	// Looks the thumbnail up in ThumbnailCache under the file at cachePath
+	// before loading or rendering anything, and stores it there once rendered.
+	// Call before Start.
+	void UseCache(ByteString newCachePath);
+
 	virtual bool doWork() override;
 	std::unique_ptr<VideoBuffer> Finish();
+	// Call before Finish.
+	std::unique_ptr<GameSave> TakeSave();
 
 	static int QueueSize();
 };
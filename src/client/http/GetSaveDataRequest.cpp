@@ -17,6 +17,8 @@ namespace http
 
 	GetSaveDataRequest::GetSaveDataRequest(int saveID, int saveDate) : Request(Url(saveID, saveDate))
 	{
+		// A specific version of a save never changes
+		Cache(saveDate ? cacheImmutable : cacheRevalidate);
 	}
 
 	std::vector<char> GetSaveDataRequest::Finish()
@@ -1,24 +1,113 @@
 #include "ImageRequest.h"
 #include "graphics/Graphics.h"
 #include "client/Client.h"
+#include "tasks/AbandonableTask.h"
 #include <iostream>
 
 namespace http
 {
+	class ImageDecodeTask : public AbandonableTask
+	{
+		std::vector<char> data;
+		Vec2<int> size;
+		std::unique_ptr<VideoBuffer> image;
+
+	public:
+		ImageDecodeTask(std::vector<char> newData, Vec2<int> newSize) : data(std::move(newData)), size(newSize)
+		{
+			priority = priorityVisible;
+		}
+
+		static std::unique_ptr<VideoBuffer> Decode(const std::vector<char> &data, Vec2<int> size)
+		{
+			auto vb = VideoBuffer::FromPNG(data);
+			if (vb)
+			{
+				vb->Resize(size, true);
+			}
+			return vb;
+		}
+
+		bool doWork() override
+		{
+			image = Decode(data, size);
+			return bool(image);
+		}
+
+		std::unique_ptr<VideoBuffer> Finish()
+		{
+			auto ptr = std::move(image);
+			AbandonableTask::Finish();
+			return ptr;
+		}
+	};
+
 	ImageRequest::ImageRequest(ByteString url, Vec2<int> newRequestedSize) : Request(url), requestedSize(newRequestedSize)
 	{
+		Cache(cacheRevalidate);
+		// Thumbnails and avatars come in dozens at a time
+		SetPriority(priorityBulk);
+	}
+
+	ImageRequest::~ImageRequest()
+	{
+		if (decodeTask)
+		{
+			decodeTask->Abandon();
+		}
+	}
+
+	bool ImageRequest::CheckDone()
+	{
+		if (!decodeStarted)
+		{
+			if (!Request::CheckDone())
+			{
+				return false;
+			}
+			decodeStarted = true;
+			try
+			{
+				auto [ status, data ] = Request::Finish();
+				ParseResponse(data, status, responseData);
+				decodeTask = new ImageDecodeTask(std::vector<char>(data.begin(), data.end()), requestedSize);
+				decodeTask->Start();
+			}
+			catch (const RequestError &ex)
+			{
+				error = ex.what();
+			}
+		}
+		if (!decodeTask)
+		{
+			return true;
+		}
+		decodeTask->Poll();
+		return decodeTask->GetDone();
 	}
 
 	std::unique_ptr<VideoBuffer> ImageRequest::Finish()
 	{
-		auto [ status, data ] = Request::Finish();
-		ParseResponse(data, status, responseData);
-		auto vb = VideoBuffer::FromPNG(std::vector<char>(data.begin(), data.end()));
-		if (vb)
+		std::unique_ptr<VideoBuffer> vb;
+		if (!decodeStarted)
+		{
+			// Not polled to completion, so decode on this thread instead
+			decodeStarted = true;
+			auto [ status, data ] = Request::Finish();
+			ParseResponse(data, status, responseData);
+			vb = ImageDecodeTask::Decode(std::vector<char>(data.begin(), data.end()), requestedSize);
+		}
+		else if (error)
 		{
-			vb->Resize(requestedSize, true);
+			throw RequestError(*error);
 		}
-		else
+		else if (decodeTask)
+		{
+			// Waits if CheckDone has not yet returned true
+			vb = decodeTask->Finish();
+			decodeTask = nullptr;
+		}
+		if (!vb)
 		{
 			vb = std::make_unique<VideoBuffer>(Vec2(15, 16));
 			vb->BlendChar(Vec2(2, 4), 0xE06E, 0xFFFFFF_rgb .WithAlpha(0xFF));
@@ -26,4 +115,3 @@ namespace http
 		return vb;
 	}
 }
-
@@ -3,18 +3,28 @@
 #include "common/Vec2.h"
 #include "Request.h"
 #include <memory>
+#include <optional>
 
 class VideoBuffer;
 
 namespace http
 {
+	class ImageDecodeTask;
+
+	// The response is decoded and resized by TaskScheduler once it arrives;
+	// CheckDone only returns true after that, so Finish does not block.
 	class ImageRequest : public Request
 	{
 		Vec2<int> requestedSize;
+		ImageDecodeTask *decodeTask = nullptr;
+		std::optional<ByteString> error;
+		bool decodeStarted = false;
 
 	public:
 		ImageRequest(ByteString url, Vec2<int> newRequestedSize);
+		~ImageRequest();
 
+		bool CheckDone();
 		std::unique_ptr<VideoBuffer> Finish();
 	};
 }
@@ -0,0 +1,41 @@
+#include "Prefetcher.h"
+
+namespace http
+{
+	void Prefetcher::Add(std::unique_ptr<Request> request)
+	{
+		request->SetPriority(Request::priorityPrefetch);
+		request->Start();
+		requests.push_back(std::move(request));
+	}
+
+	void Prefetcher::Update()
+	{
+		for (auto it = requests.begin(); it != requests.end(); )
+		{
+			// Qualified so that derived requests such as ImageRequest do not
+			// process responses nobody is going to look at
+			if ((*it)->Request::CheckDone())
+			{
+				try
+				{
+					// The response is in the cache by now
+					(*it)->Request::Finish();
+				}
+				catch (const RequestError &)
+				{
+				}
+				it = requests.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	void Prefetcher::Clear()
+	{
+		requests.clear();
+	}
+}
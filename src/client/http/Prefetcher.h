@@ -0,0 +1,23 @@
+#pragma once
+#include "Request.h"
+#include <memory>
+#include <vector>
+
+namespace http
+{
+	// Runs requests at prefetch priority only so that the response cache has
+	// their responses by the time they are made for real; the responses are
+	// otherwise thrown away, as are errors. Requests that are still running
+	// are cancelled by Clear and on destruction. Only the Request side of a
+	// request is ever finished, so for example an ImageRequest's response is
+	// cached but never decoded.
+	class Prefetcher
+	{
+		std::vector<std::unique_ptr<Request>> requests;
+
+	public:
+		void Add(std::unique_ptr<Request> request);
+		void Update();
+		void Clear();
+	};
+}
@@ -74,6 +74,25 @@ namespace http
 		}
 	}
 
+	void Request::Cache(CachePolicy newCachePolicy)
+	{
+		assert(handle->state == RequestHandle::ready);
+		handle->cachePolicy = newCachePolicy;
+	}
+
+	void Request::SetPriority(Priority newPriority)
+	{
+		{
+			std::lock_guard lk(handle->stateMx);
+			if (handle->state == RequestHandle::ready)
+			{
+				handle->priority = newPriority;
+				return;
+			}
+		}
+		RequestManager::Ref().PrioritiseRequest(*this, newPriority);
+	}
+
 	void Request::Start()
 	{
 		assert(handle->state == RequestHandle::ready);
@@ -105,7 +124,8 @@ namespace http
 	void Request::Wait()
 	{
 		std::unique_lock lk(handle->stateMx);
-		assert(handle->state == RequestHandle::running);
+		// Requests served from the response cache are done as soon as they are started
+		assert(handle->state == RequestHandle::running || handle->state == RequestHandle::done);
 		handle->stateCv.wait(lk, [this]() {
 			return handle->state == RequestHandle::done;
 		});
@@ -136,6 +156,8 @@ namespace http
 
 	void RequestHandle::MarkDone()
 	{
+		// Before the request is marked done, while the response is still ours to look at
+		RequestManager::Ref().RecordDone(*this);
 		{
 			std::lock_guard lk(stateMx);
 			assert(state == RequestHandle::running);
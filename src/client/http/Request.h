@@ -26,7 +26,7 @@ namespace http
 		Request(ByteString newUri);
 		Request(const Request &) = delete;
 		Request &operator =(const Request &) = delete;
-		~Request();
+		virtual ~Request();
 
 		void FailEarly(ByteString error);
 
@@ -36,6 +36,28 @@ namespace http
 		void AddPostData(PostData data);
 		void AuthHeaders(ByteString ID, ByteString session);
 
+		enum CachePolicy
+		{
+			cacheNone,
+			cacheRevalidate, // served from the response cache if the server says it has not changed
+			cacheImmutable, // served from the response cache without asking the server
+		};
+		void Cache(CachePolicy newCachePolicy);
+
+		// Interactive requests are handed to the network before bulk ones,
+		// and bulk ones may not take up every transfer slot. Prefetches wait
+		// until nothing else does. A request that has already been started can
+		// be moved to another class, e.g. when the user navigates to something
+		// that was being prefetched.
+		enum Priority
+		{
+			priorityPrefetch, // for something the user may or may not want next
+			priorityBulk, // many at a time, with nobody waiting on any one in particular
+			priorityInteractive, // default
+			priorityCount,
+		};
+		void SetPriority(Priority newPriority);
+
 		void Start();
 		bool CheckDone() const;
 
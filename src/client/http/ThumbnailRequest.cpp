@@ -10,6 +10,8 @@ namespace http
 			: ByteString::Build(STATICSCHEME, STATICSERVER, "/", saveID, "_small.png")
 		), size)
 	{
+		// A specific version of a save never changes
+		Cache(saveDate ? cacheImmutable : cacheRevalidate);
 	}
 }
 
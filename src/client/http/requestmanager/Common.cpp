@@ -1,4 +1,5 @@
 #include "RequestManager.h"
+#include "ResponseCache.h"
 #include "client/http/Request.h"
 #include "Config.h"
 
@@ -19,10 +20,14 @@ namespace http
 			"; ", IDENT,
 			") TPTPP/", apiVersion[0], ".", apiVersion[1], ".", APP_VERSION.build, IDENT_RELTYPE, ".", APP_VERSION.build
 		);
+		responseCache = std::make_unique<ResponseCache>(HTTP_CACHE_DIR, httpCacheMaxBytes);
 	}
 
+	RequestManager::~RequestManager() = default;
+
 	void RequestManager::RegisterRequest(Request &request)
 	{
+		request.handle->startTime = std::chrono::steady_clock::now();
 		if (request.handle->failEarly)
 		{
 			request.handle->error = request.handle->failEarly.value();
@@ -30,18 +35,110 @@ namespace http
 			request.handle->MarkDone();
 			return;
 		}
+		RegisterRequestImpl(request);
+	}
+
+	static bool Cacheable(const RequestHandle &handle)
+	{
+		// Only plain GETs are cached; anything else may have side effects or
+		// depend on what is posted
+		return handle.cachePolicy != Request::cacheNone && !handle.isPost && !handle.verb;
+	}
+
+	bool RequestManager::ServeFromCache(RequestHandle &handle)
+	{
+		auto cacheable = Cacheable(handle);
+		if (cacheable && handle.cachePolicy == Request::cacheImmutable)
+		{
+			if (auto body = responseCache->Get(handle.uri))
+			{
+				handle.statusCode = 200;
+				handle.responseData = std::move(*body);
+				handle.fromCache = true;
+				return true;
+			}
+		}
 		if (disableNetwork)
 		{
-			request.handle->statusCode = 604;
-			request.handle->error = "network disabled upon request";
-			request.handle->MarkDone();
-			return;
+			handle.statusCode = 604;
+			handle.error = "network disabled upon request";
+			return true;
 		}
-		RegisterRequestImpl(request);
+		if (cacheable && handle.cachePolicy == Request::cacheRevalidate)
+		{
+			auto validators = responseCache->Validators(handle.uri);
+			handle.revalidating = validators.size();
+			handle.headers.insert(handle.headers.end(), validators.begin(), validators.end());
+		}
+		return false;
 	}
 
 	void RequestManager::UnregisterRequest(Request &request)
 	{
 		UnregisterRequestImpl(request);
 	}
+
+	void RequestManager::PrioritiseRequest(Request &request, Request::Priority priority)
+	{
+		PrioritiseRequestImpl(request, priority);
+	}
+
+	void RequestManager::RecordDone(const RequestHandle &handle)
+	{
+		using Seconds = std::chrono::duration<double>;
+		auto now = std::chrono::steady_clock::now();
+		std::lock_guard lk(statsMx);
+		auto &classStats = stats[handle.priority];
+		classStats.completed += 1;
+		if (handle.error || handle.statusCode >= 400)
+		{
+			classStats.failed += 1;
+		}
+		if (handle.fromCache)
+		{
+			classStats.fromCache += 1;
+		}
+		classStats.bytes += int64_t(handle.responseData.size());
+		classStats.totalSeconds += Seconds(now - handle.startTime).count();
+		if (handle.transferStartTime)
+		{
+			classStats.queueSeconds += Seconds(*handle.transferStartTime - handle.startTime).count();
+			classStats.transferSeconds += Seconds(now - *handle.transferStartTime).count();
+		}
+	}
+
+	void RequestManager::RecordQueue(Request::Priority priority, int queued, int active)
+	{
+		std::lock_guard lk(statsMx);
+		stats[priority].queued = queued;
+		stats[priority].active = active;
+	}
+
+	RequestStatsArray RequestManager::GetStats()
+	{
+		std::lock_guard lk(statsMx);
+		return stats;
+	}
+
+	void RequestManager::CacheResponse(RequestHandle &handle)
+	{
+		if (!Cacheable(handle) || handle.fromCache || handle.error)
+		{
+			return;
+		}
+		if (handle.statusCode == 304 && handle.revalidating)
+		{
+			// If the entry has been evicted since, the 304 is passed on as is
+			if (auto body = responseCache->GetRevalidated(handle.uri))
+			{
+				handle.statusCode = 200;
+				handle.responseData = std::move(*body);
+			}
+			return;
+		}
+		if (handle.statusCode == 200 && handle.responseData.size())
+		{
+			responseCache->Put(handle.uri, handle.responseData, handle.responseHeaders, handle.cachePolicy == Request::cacheImmutable);
+		}
+	}
 }
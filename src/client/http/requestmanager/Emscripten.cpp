@@ -87,6 +87,11 @@ namespace http
 		manager->Wake();
 	}
 
+	void RequestManager::PrioritiseRequestImpl(Request &request, Request::Priority priority)
+	{
+		// The browser schedules fetches on its own
+	}
+
 	void RequestManagerImpl::HandleWake()
 	{
 		{
@@ -103,7 +108,14 @@ namespace http
 				// Must not be present
 				assert(std::find(requestHandles.begin(), requestHandles.end(), requestHandle) == requestHandles.end());
 				requestHandles.push_back(requestHandle);
-				RegisterRequestHandle(requestHandle);
+				if (ServeFromCache(*requestHandle))
+				{
+					requestHandlesToUnregister.push_back(requestHandle);
+				}
+				else
+				{
+					RegisterRequestHandle(requestHandle);
+				}
 			}
 			requestHandlesToRegister.clear();
 			for (auto &requestHandle : requestHandlesToUnregister)
@@ -348,6 +360,7 @@ namespace http
 				}, handle->id, i), free).get());
 			}
 			handle->gotResponse = true;
+			CacheResponse(*handle);
 			HandleWake();
 		}
 	}
@@ -355,7 +368,11 @@ namespace http
 	void RequestManagerImpl::UnregisterRequestHandle(std::shared_ptr<RequestHandle> requestHandle)
 	{
 		auto handle = static_cast<RequestHandleHttp *>(requestHandle.get());
-		assert(handle->id >= 0);
+		if (handle->id < 0)
+		{
+			// Served by ServeFromCache, never went to the network
+			return;
+		}
 		EM_ASM({
 			let request = Module.emscriptenRequestManager.requests[$0];
 			request.alive = false;
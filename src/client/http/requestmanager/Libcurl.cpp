@@ -18,9 +18,11 @@
 # define REQUEST_USE_CURL_MULTI_POLL
 #endif
 
-constexpr long curlMaxHostConnections   = 1;
+constexpr long curlMaxHostConnections   = httpMaxHostConnections;
 constexpr long curlMaxConcurrentStreams = httpMaxConcurrentStreams;
 constexpr long curlConnectTimeoutS      = httpConnectTimeoutS;
+// Only matters to HTTP/2 servers, which split bandwidth between streams by weight
+constexpr long curlStreamWeights[]      = { 1, 16, 256 }; // by Request::Priority
 
 namespace http
 {
@@ -63,6 +65,7 @@ namespace http
 		char curlErrorBuffer[CURL_ERROR_SIZE];
 		bool curlAddedToMulti = false;
 		bool gotStatusLine = false;
+		bool cacheChecked = false;
 
 		RequestHandleHttp() : RequestHandle(CtorTag{})
 		{
@@ -131,12 +134,18 @@ namespace http
 		// State shared between Request threads and the worker thread.
 		std::vector<std::shared_ptr<RequestHandle>> requestHandlesToRegister;
 		std::vector<std::shared_ptr<RequestHandle>> requestHandlesToUnregister;
+		std::vector<std::pair<std::shared_ptr<RequestHandle>, Request::Priority>> requestHandlesToPrioritise;
 		bool running = true;
 		std::mutex sharedStateMx;
 
 		std::vector<std::shared_ptr<RequestHandle>> requestHandles;
+		// Registered but not yet handed to curl, in the order they were registered
+		std::vector<std::shared_ptr<RequestHandle>> pendingHandles;
 		void RegisterRequestHandle(std::shared_ptr<RequestHandle> requestHandle);
 		void UnregisterRequestHandle(std::shared_ptr<RequestHandle> requestHandle);
+		void PrioritiseRequestHandle(std::shared_ptr<RequestHandle> requestHandle, Request::Priority priority);
+		void AdmitPendingHandles();
+		void CheckCache(RequestHandle &requestHandle);
 
 		bool curlGlobalInit = false;
 		CURLM *curlMulti = NULL;
@@ -195,6 +204,9 @@ namespace http
 			if (curlMulti)
 			{
 				HandleCURLMcode(curl_multi_setopt(curlMulti, CURLMOPT_MAX_HOST_CONNECTIONS, curlMaxHostConnections));
+#if defined(CURL_AT_LEAST_VERSION) && CURL_AT_LEAST_VERSION(7, 43, 0)
+				HandleCURLMcode(curl_multi_setopt(curlMulti, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX));
+#endif
 #if defined(CURL_AT_LEAST_VERSION) && CURL_AT_LEAST_VERSION(7, 67, 0)
 				HandleCURLMcode(curl_multi_setopt(curlMulti, CURLMOPT_MAX_CONCURRENT_STREAMS, curlMaxConcurrentStreams));
 #endif
@@ -255,6 +267,7 @@ namespace http
 				{
 					handle->error = handle->curlErrorBuffer;
 				}
+				CacheResponse(*handle);
 			}
 		}
 		for (auto &requestHandle : requestHandles)
@@ -294,6 +307,19 @@ namespace http
 		WorkerInit();
 		while (true)
 		{
+			{
+				// Looking requests up in the response cache may read from disk, so
+				// it is done without holding up threads that want to start requests
+				std::vector<std::shared_ptr<RequestHandle>> toCheck;
+				{
+					std::lock_guard lk(sharedStateMx);
+					toCheck = requestHandlesToRegister;
+				}
+				for (auto &requestHandle : toCheck)
+				{
+					CheckCache(*requestHandle);
+				}
+			}
 			{
 				std::lock_guard lk(sharedStateMx);
 				// Register new handles first. This always succeeds even if the handle is "failed early" so that
@@ -303,9 +329,20 @@ namespace http
 					// Must not be present
 					assert(std::find(requestHandles.begin(), requestHandles.end(), requestHandle) == requestHandles.end());
 					requestHandles.push_back(requestHandle);
+					// Only does anything for handles registered since the lookups above
+					CheckCache(*requestHandle);
 					RegisterRequestHandle(requestHandle);
 				}
 				requestHandlesToRegister.clear();
+				// Priorities only change for handles still registered; anything done by now stays done.
+				for (auto &[ requestHandle, priority ] : requestHandlesToPrioritise)
+				{
+					if (std::find(requestHandles.begin(), requestHandles.end(), requestHandle) != requestHandles.end())
+					{
+						PrioritiseRequestHandle(requestHandle, priority);
+					}
+				}
+				requestHandlesToPrioritise.clear();
 				// Then unregister done handles. As explained above, registering a new handle may also immediately mark
 				// it done and we won't be coming back here until Wait() returns, so this has to come second.
 				for (auto &requestHandle : requestHandles)
@@ -331,6 +368,7 @@ namespace http
 					}
 				}
 				requestHandlesToUnregister.clear();
+				AdmitPendingHandles();
 				if (!running)
 				{
 					break;
@@ -362,10 +400,35 @@ namespace http
 		manager->Wake();
 	}
 
+	void RequestManager::PrioritiseRequestImpl(Request &request, Request::Priority priority)
+	{
+		auto manager = static_cast<RequestManagerImpl *>(this);
+		{
+			std::lock_guard lk(manager->sharedStateMx);
+			manager->requestHandlesToPrioritise.push_back({ request.handle, priority });
+		}
+		manager->Wake();
+	}
+
+	void RequestManagerImpl::CheckCache(RequestHandle &requestHandle)
+	{
+		auto &handle = static_cast<RequestHandleHttp &>(requestHandle);
+		if (!handle.cacheChecked)
+		{
+			handle.cacheChecked = true;
+			ServeFromCache(handle);
+		}
+	}
+
 	void RequestManagerImpl::RegisterRequestHandle(std::shared_ptr<RequestHandle> requestHandle)
 	{
 		auto manager = static_cast<RequestManagerImpl *>(this);
 		auto handle = static_cast<RequestHandleHttp *>(requestHandle.get());
+		if (handle->statusCode)
+		{
+			// Served by ServeFromCache; unregistered and marked done further down in Worker
+			return;
+		}
 		auto failEarly = [&requestHandle](int statusCode, ByteString error) {
 			requestHandle->statusCode = statusCode;
 			requestHandle->error = error;
@@ -504,20 +567,105 @@ namespace http
 				HandleCURLcode(curl_easy_setopt(handle->curlEasy, CURLOPT_HEADERFUNCTION, &RequestHandleHttp::HeaderDataHandler));
 				HandleCURLcode(curl_easy_setopt(handle->curlEasy, CURLOPT_WRITEDATA, (void *)handle));
 				HandleCURLcode(curl_easy_setopt(handle->curlEasy, CURLOPT_WRITEFUNCTION, &RequestHandleHttp::WriteDataHandler));
+				// Keep connections around for the requests that follow
+				HandleCURLcode(curl_easy_setopt(handle->curlEasy, CURLOPT_TCP_KEEPALIVE, 1L));
+#if defined(CURL_AT_LEAST_VERSION) && CURL_AT_LEAST_VERSION(7, 43, 0)
+				// Rather wait for a connection that can be multiplexed than open another
+				HandleCURLcode(curl_easy_setopt(handle->curlEasy, CURLOPT_PIPEWAIT, 1L));
+#endif
+#if defined(CURL_AT_LEAST_VERSION) && CURL_AT_LEAST_VERSION(7, 46, 0)
+				HandleCURLcode(curl_easy_setopt(handle->curlEasy, CURLOPT_STREAM_WEIGHT, curlStreamWeights[handle->priority]));
+#endif
 			}
 		}
 		catch (const CurlError &ex)
 		{
 			return failEarly(600, ex.what());
 		}
-		HandleCURLMcode(curl_multi_add_handle(manager->curlMulti, handle->curlEasy));
-		handle->curlAddedToMulti = true;
+		manager->pendingHandles.push_back(requestHandle);
+	}
+
+	void RequestManagerImpl::PrioritiseRequestHandle(std::shared_ptr<RequestHandle> requestHandle, Request::Priority priority)
+	{
+		auto handle = static_cast<RequestHandleHttp *>(requestHandle.get());
+		// Pending handles are admitted in their new class by AdmitPendingHandles
+		handle->priority = priority;
+#if defined(CURL_AT_LEAST_VERSION) && CURL_AT_LEAST_VERSION(7, 46, 0)
+		if (handle->curlEasy)
+		{
+			HandleCURLcode(curl_easy_setopt(handle->curlEasy, CURLOPT_STREAM_WEIGHT, curlStreamWeights[handle->priority]));
+		}
+#endif
+	}
+
+	void RequestManagerImpl::AdmitPendingHandles()
+	{
+		std::array<int, Request::priorityCount> active{};
+		for (auto &requestHandle : requestHandles)
+		{
+			if (static_cast<RequestHandleHttp *>(requestHandle.get())->curlAddedToMulti)
+			{
+				active[requestHandle->priority] += 1;
+			}
+		}
+		auto totalActive = 0;
+		for (auto count : active)
+		{
+			totalActive += count;
+		}
+		// Interactive requests first, then bulk ones, then prefetches, each in the order they were registered
+		auto othersPending = false;
+		for (auto priority : { Request::priorityInteractive, Request::priorityBulk, Request::priorityPrefetch })
+		{
+			auto limit = httpMaxTransfers;
+			if (priority == Request::priorityBulk)
+			{
+				limit = httpMaxBulkTransfers;
+			}
+			if (priority == Request::priorityPrefetch)
+			{
+				// Anything else still waiting for a slot is more useful
+				limit = othersPending ? 0 : httpMaxPrefetchTransfers;
+			}
+			for (auto it = pendingHandles.begin(); it != pendingHandles.end(); )
+			{
+				auto handle = static_cast<RequestHandleHttp *>(it->get());
+				if (handle->priority != priority)
+				{
+					++it;
+					continue;
+				}
+				if (totalActive >= httpMaxTransfers || active[priority] >= limit)
+				{
+					break;
+				}
+				HandleCURLMcode(curl_multi_add_handle(curlMulti, handle->curlEasy));
+				handle->curlAddedToMulti = true;
+				handle->transferStartTime = std::chrono::steady_clock::now();
+				active[priority] += 1;
+				totalActive += 1;
+				it = pendingHandles.erase(it);
+			}
+			othersPending = othersPending || std::any_of(pendingHandles.begin(), pendingHandles.end(), [priority](auto &requestHandle) {
+				return requestHandle->priority == priority;
+			});
+		}
+		std::array<int, Request::priorityCount> queued{};
+		for (auto &requestHandle : pendingHandles)
+		{
+			queued[requestHandle->priority] += 1;
+		}
+		for (auto priority = 0; priority < Request::priorityCount; priority++)
+		{
+			RecordQueue(Request::Priority(priority), queued[priority], active[priority]);
+		}
 	}
 
 	void RequestManagerImpl::UnregisterRequestHandle(std::shared_ptr<RequestHandle> requestHandle)
 	{
 		auto manager = static_cast<RequestManagerImpl *>(this);
 		auto handle = static_cast<RequestHandleHttp *>(requestHandle.get());
+		manager->pendingHandles.erase(std::remove(manager->pendingHandles.begin(), manager->pendingHandles.end(), requestHandle), manager->pendingHandles.end());
 		if (handle->curlAddedToMulti)
 		{
 			HandleCURLMcode(curl_multi_remove_handle(manager->curlMulti, handle->curlEasy));
@@ -10,8 +10,11 @@ namespace http
 
 	void RequestManager::RegisterRequestImpl(Request &request)
 	{
-		request.handle->statusCode = 604;
-		request.handle->error = "network support not compiled in";
+		if (!ServeFromCache(*request.handle))
+		{
+			request.handle->statusCode = 604;
+			request.handle->error = "network support not compiled in";
+		}
 		request.handle->MarkDone();
 	}
 
@@ -19,6 +22,10 @@ namespace http
 	{
 	}
 
+	void RequestManager::PrioritiseRequestImpl(Request &request, Request::Priority priority)
+	{
+	}
+
 	RequestManagerPtr RequestManager::Create(ByteString newProxy, ByteString newCafile, ByteString newCapath, bool newDisableNetwork)
 	{
 		return RequestManagerPtr(new RequestManager(newProxy, newCafile, newCapath, newDisableNetwork));
@@ -2,7 +2,10 @@
 #include "common/ExplicitSingleton.h"
 #include "common/String.h"
 #include "client/http/PostData.h"
+#include "client/http/Request.h"
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <thread>
 #include <vector>
@@ -14,7 +17,22 @@
 
 namespace http
 {
-	class Request;
+	class ResponseCache;
+
+	struct RequestStats
+	{
+		int queued = 0; // waiting for a transfer slot
+		int active = 0;
+		int completed = 0;
+		int failed = 0;
+		int fromCache = 0;
+		int64_t bytes = 0;
+		// Summed over completed requests
+		double totalSeconds = 0; // from Start to done
+		double queueSeconds = 0; // spent waiting for a transfer slot
+		double transferSeconds = 0;
+	};
+	using RequestStatsArray = std::array<RequestStats, Request::priorityCount>;
 
 	struct RequestHandle
 	{
@@ -47,6 +65,12 @@ namespace http
 		std::vector<Header> responseHeaders;
 		std::optional<ByteString> error;
 		std::optional<ByteString> failEarly;
+		Request::CachePolicy cachePolicy = Request::cacheNone;
+		bool revalidating = false;
+		bool fromCache = false;
+		Request::Priority priority = Request::priorityInteractive;
+		std::chrono::steady_clock::time_point startTime;
+		std::optional<std::chrono::steady_clock::time_point> transferStartTime;
 
 		RequestHandle(CtorTag)
 		{
@@ -74,15 +98,44 @@ namespace http
 		ByteString capath;
 		ByteString userAgent;
 		bool disableNetwork;
+		std::unique_ptr<ResponseCache> responseCache;
+		RequestStatsArray stats;
+		std::mutex statsMx;
 
 		RequestManager(ByteString newProxy, ByteString newCafile, ByteString newCapath, bool newDisableNetwork);
 
+		// Called by the backend for each request before it goes to the network,
+		// on the backend's own thread where it has one, as this may read from
+		// disk. Returns true, with statusCode set, if the request has been dealt
+		// with: served from the response cache, or failed because the network
+		// is disabled. Otherwise adds whatever headers revalidating a cached
+		// response takes.
+		bool ServeFromCache(RequestHandle &handle);
+		// Called by the backend, likewise, once a response has arrived and before
+		// the handle is marked done. Stores a successful response or, if the
+		// server says the cached response is still good, substitutes it.
+		void CacheResponse(RequestHandle &handle);
+
 		void RegisterRequestImpl(Request &request);
 		void UnregisterRequestImpl(Request &request);
+		void PrioritiseRequestImpl(Request &request, Request::Priority priority);
 
 	public:
+		~RequestManager();
+
 		void RegisterRequest(Request &request);
 		void UnregisterRequest(Request &request);
+		// Called by Request::SetPriority once the request has been started.
+		void PrioritiseRequest(Request &request, Request::Priority priority);
+		// Called by RequestHandle::MarkDone, from any thread.
+		void RecordDone(const RequestHandle &handle);
+		void RecordQueue(Request::Priority priority, int queued, int active);
+
+		RequestStatsArray GetStats();
+		ResponseCache &GetResponseCache()
+		{
+			return *responseCache;
+		}
 
 		bool DisableNetwork() const
 		{
@@ -0,0 +1,261 @@
+#include "ResponseCache.h"
+#include "common/CacheFile.h"
+#include "common/platform/Platform.h"
+#include "Config.h"
+#include <algorithm>
+#include <iostream>
+#include <unordered_set>
+#include <json/json.h>
+
+namespace http
+{
+	constexpr char cacheMagic[] = "TPTHTTP1\n";
+	constexpr char indexName[] = "index.json";
+	// Writing the index is not free, so it is only done after this many
+	// entries have been added or removed, and on exit
+	constexpr int saveInterval = 32;
+
+	static ByteString FindHeader(const std::vector<Header> &headers, ByteString name)
+	{
+		for (auto &header : headers)
+		{
+			if (header.name.ToLower() == name)
+			{
+				return header.value;
+			}
+		}
+		return "";
+	}
+
+	ResponseCache::ResponseCache(ByteString newDir, int64_t newMaxBytes) : dir(newDir), maxBytes(newMaxBytes)
+	{
+	}
+
+	ResponseCache::~ResponseCache()
+	{
+		std::lock_guard lk(mx);
+		if (dirty)
+		{
+			Save();
+		}
+	}
+
+	ByteString ResponseCache::EntryPath(const ByteString &uri) const
+	{
+		return ByteString::Build(dir, PATH_SEP_CHAR, CacheFile::EntryName(uri, ".http"));
+	}
+
+	void ResponseCache::Load()
+	{
+		if (loaded)
+		{
+			return;
+		}
+		loaded = true;
+		if (!Platform::DirectoryExists(dir))
+		{
+			return;
+		}
+		auto indexPath = ByteString::Build(dir, PATH_SEP_CHAR, indexName);
+		std::vector<char> data;
+		if (Platform::FileExists(indexPath) && Platform::ReadFile(data, indexPath) && data.size())
+		{
+			Json::CharReaderBuilder rbuilder;
+			std::unique_ptr<Json::CharReader> const reader(rbuilder.newCharReader());
+			Json::Value root;
+			ByteString errs;
+			if (reader->parse(&data[0], &data[0] + data.size(), &root, &errs) && root.isObject())
+			{
+				clock = root.get("clock", 0).asUInt64();
+				for (auto &item : root["entries"])
+				{
+					Entry entry;
+					entry.size = item.get("size", 0).asInt64();
+					entry.etag = item.get("etag", "").asString();
+					entry.lastModified = item.get("lastModified", "").asString();
+					entry.lastUsed = item.get("lastUsed", 0).asUInt64();
+					entries[item.get("uri", "").asString()] = entry;
+					totalBytes += entry.size;
+				}
+			}
+			else
+			{
+				std::cerr << errs << std::endl;
+			}
+		}
+		// Entries added since the index was last written are lost, as are
+		// those whose files have gone missing
+		std::unordered_set<ByteString, std::hash<std::string>> known;
+		for (auto it = entries.begin(); it != entries.end(); )
+		{
+			auto path = EntryPath(it->first);
+			if (Platform::FileExists(path))
+			{
+				known.insert(CacheFile::EntryName(it->first, ".http"));
+				++it;
+			}
+			else
+			{
+				totalBytes -= it->second.size;
+				it = entries.erase(it);
+				dirty = true;
+			}
+		}
+		for (auto &name : Platform::DirectoryList(dir))
+		{
+			if (name.size() > 5 && name.EndsWith(".http") && known.find(name) == known.end())
+			{
+				Platform::RemoveFile(ByteString::Build(dir, PATH_SEP_CHAR, name));
+			}
+		}
+	}
+
+	void ResponseCache::Save()
+	{
+		Json::Value root;
+		root["clock"] = Json::UInt64(clock);
+		root["entries"] = Json::arrayValue;
+		for (auto &[ uri, entry ] : entries)
+		{
+			Json::Value item;
+			item["uri"] = uri;
+			item["size"] = Json::Int64(entry.size);
+			item["etag"] = entry.etag;
+			item["lastModified"] = entry.lastModified;
+			item["lastUsed"] = Json::UInt64(entry.lastUsed);
+			root["entries"].append(item);
+		}
+		Json::StreamWriterBuilder wbuilder;
+		wbuilder["indentation"] = "";
+		ByteString data = Json::writeString(wbuilder, root);
+		if (!Platform::DirectoryExists(dir))
+		{
+			Platform::MakeDirectory(dir);
+		}
+		if (Platform::WriteFile(std::vector<char>(data.begin(), data.end()), ByteString::Build(dir, PATH_SEP_CHAR, indexName)))
+		{
+			dirty = false;
+			unsavedChanges = 0;
+		}
+	}
+
+	void ResponseCache::Remove(std::map<ByteString, Entry>::iterator it)
+	{
+		Platform::RemoveFile(EntryPath(it->first));
+		totalBytes -= it->second.size;
+		entries.erase(it);
+		dirty = true;
+		unsavedChanges += 1;
+	}
+
+	std::optional<ByteString> ResponseCache::Use(const ByteString &uri, int &counter)
+	{
+		Load();
+		auto it = entries.find(uri);
+		if (it == entries.end())
+		{
+			return std::nullopt;
+		}
+		auto data = CacheFile::Read(EntryPath(uri), ByteString::Build(cacheMagic, uri, "\n"));
+		if (!data)
+		{
+			Remove(it);
+			return std::nullopt;
+		}
+		it->second.lastUsed = ++clock;
+		dirty = true;
+		counter += 1;
+		return ByteString(data->begin(), data->end());
+	}
+
+	std::optional<ByteString> ResponseCache::Get(const ByteString &uri)
+	{
+		std::lock_guard lk(mx);
+		return Use(uri, stats.hits);
+	}
+
+	std::optional<ByteString> ResponseCache::GetRevalidated(const ByteString &uri)
+	{
+		std::lock_guard lk(mx);
+		return Use(uri, stats.revalidated);
+	}
+
+	std::vector<Header> ResponseCache::Validators(const ByteString &uri)
+	{
+		std::lock_guard lk(mx);
+		Load();
+		std::vector<Header> headers;
+		auto it = entries.find(uri);
+		if (it != entries.end())
+		{
+			if (it->second.etag.size())
+			{
+				headers.push_back({ "If-None-Match", it->second.etag });
+			}
+			if (it->second.lastModified.size())
+			{
+				headers.push_back({ "If-Modified-Since", it->second.lastModified });
+			}
+		}
+		return headers;
+	}
+
+	void ResponseCache::Put(const ByteString &uri, const ByteString &body, const std::vector<Header> &responseHeaders, bool immutable)
+	{
+		Entry entry;
+		entry.etag = FindHeader(responseHeaders, "etag");
+		entry.lastModified = FindHeader(responseHeaders, "last-modified");
+		if (!immutable && !entry.etag.size() && !entry.lastModified.size())
+		{
+			return;
+		}
+		if (FindHeader(responseHeaders, "cache-control").Contains("no-store"))
+		{
+			return;
+		}
+		auto header = ByteString::Build(cacheMagic, uri, "\n");
+		entry.size = int64_t(header.size() + body.size());
+		// Anything this large would push out much of the rest of the cache
+		if (entry.size > maxBytes / 16)
+		{
+			return;
+		}
+
+		std::lock_guard lk(mx);
+		Load();
+		auto it = entries.find(uri);
+		if (it != entries.end())
+		{
+			totalBytes -= it->second.size;
+			entries.erase(it);
+		}
+		dirty = true;
+		unsavedChanges += 1;
+		if (!CacheFile::Write(dir, EntryPath(uri), header, body.data(), body.size()))
+		{
+			return;
+		}
+		entry.lastUsed = ++clock;
+		entries[uri] = entry;
+		totalBytes += entry.size;
+		stats.stores += 1;
+		while (totalBytes > maxBytes)
+		{
+			auto oldest = std::min_element(entries.begin(), entries.end(), [](auto &lhs, auto &rhs) {
+				return lhs.second.lastUsed < rhs.second.lastUsed;
+			});
+			Remove(oldest);
+			stats.evictions += 1;
+		}
+		if (unsavedChanges >= saveInterval)
+		{
+			Save();
+		}
+	}
+
+	ResponseCache::Stats ResponseCache::GetStats()
+	{
+		std::lock_guard lk(mx);
+		return stats;
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "common/String.h"
+#include "client/http/PostData.h"
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace http
+{
+	// Keeps response bodies on disk, keyed by URI, along with whatever the
+	// server sent to validate them with. Once the cache grows past its size
+	// limit, entries are evicted least recently used first. The index is kept
+	// in memory and only written back every so often; files it does not know
+	// about are removed when it is loaded. Everything but GetStats reads or
+	// writes files, so RequestManager only uses the cache from its backend's
+	// thread.
+	class ResponseCache
+	{
+	public:
+		struct Stats
+		{
+			// Responses served without a round trip
+			int hits = 0;
+			// Responses served after the server said they had not changed
+			int revalidated = 0;
+			int stores = 0;
+			int evictions = 0;
+		};
+
+	private:
+		struct Entry
+		{
+			int64_t size = 0;
+			ByteString etag;
+			ByteString lastModified;
+			uint64_t lastUsed = 0;
+		};
+
+		ByteString dir;
+		int64_t maxBytes;
+		std::mutex mx;
+		bool loaded = false;
+		bool dirty = false;
+		int unsavedChanges = 0;
+		uint64_t clock = 0;
+		int64_t totalBytes = 0;
+		std::map<ByteString, Entry> entries;
+		Stats stats;
+
+		ByteString EntryPath(const ByteString &uri) const;
+		void Load();
+		void Save();
+		void Remove(std::map<ByteString, Entry>::iterator it);
+		std::optional<ByteString> Use(const ByteString &uri, int &counter);
+
+	public:
+		ResponseCache(ByteString newDir, int64_t newMaxBytes);
+		~ResponseCache();
+
+		// Body of the entry for uri, if there is one.
+		std::optional<ByteString> Get(const ByteString &uri);
+		// Conditional request headers to revalidate the entry for uri with;
+		// empty if there is nothing to revalidate.
+		std::vector<Header> Validators(const ByteString &uri);
+		// Responses that the server gave no way to revalidate are only stored
+		// if they are known never to change.
+		void Put(const ByteString &uri, const ByteString &body, const std::vector<Header> &responseHeaders, bool immutable);
+		// Same as Get, but counts the use as a successful revalidation.
+		std::optional<ByteString> GetRevalidated(const ByteString &uri);
+
+		Stats GetStats();
+	};
+}
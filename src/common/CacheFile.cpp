@@ -0,0 +1,97 @@
+#include "CacheFile.h"
+#include "common/platform/Platform.h"
+#include "Config.h"
+#include <algorithm>
+
+namespace CacheFile
+{
+	uint64_t Hash(const char *data, size_t size)
+	{
+		uint64_t hash = UINT64_C(0xCBF29CE484222325);
+		for (size_t i = 0; i < size; i++)
+		{
+			hash = (hash ^ uint8_t(data[i])) * UINT64_C(0x100000001B3);
+		}
+		return hash;
+	}
+
+	ByteString HashString(const char *data, size_t size)
+	{
+		return ByteString::Build(Format::Hex(), Format::Width(16), Format::Fill('0'), Hash(data, size));
+	}
+
+	ByteString EntryName(const ByteString &name, const ByteString &extension)
+	{
+		return HashString(name.data(), name.size()) + extension;
+	}
+
+	std::optional<std::vector<char>> Read(const ByteString &path, const ByteString &header)
+	{
+		std::vector<char> data;
+		if (!Platform::FileExists(path) || !Platform::ReadFile(data, path))
+		{
+			return std::nullopt;
+		}
+		if (data.size() < header.size() || !std::equal(header.begin(), header.end(), data.begin()))
+		{
+			return std::nullopt;
+		}
+		data.erase(data.begin(), data.begin() + header.size());
+		return data;
+	}
+
+	bool Write(const ByteString &dir, const ByteString &path, const ByteString &header, const char *body, size_t size)
+	{
+		std::vector<char> data;
+		data.reserve(header.size() + size);
+		data.insert(data.end(), header.begin(), header.end());
+		data.insert(data.end(), body, body + size);
+		if (!Platform::DirectoryExists(dir))
+		{
+			Platform::MakeDirectory(dir);
+		}
+		return Platform::WriteFile(data, path);
+	}
+
+	void Prune(const ByteString &dir, const ByteString &extension, uint64_t maxBytes)
+	{
+		struct Item
+		{
+			ByteString path;
+			Platform::FileInfo info;
+		};
+		std::vector<Item> items;
+		uint64_t totalBytes = 0;
+		for (auto &name : Platform::DirectoryList(dir))
+		{
+			if (name.size() <= extension.size() || !name.EndsWith(extension))
+			{
+				continue;
+			}
+			auto path = ByteString::Build(dir, PATH_SEP_CHAR, name);
+			if (auto info = Platform::GetFileInfo(path))
+			{
+				items.push_back({ path, *info });
+				totalBytes += info->size;
+			}
+		}
+		if (totalBytes <= maxBytes)
+		{
+			return;
+		}
+		std::sort(items.begin(), items.end(), [](auto &lhs, auto &rhs) {
+			return lhs.info.modified < rhs.info.modified;
+		});
+		for (auto &item : items)
+		{
+			if (totalBytes <= maxBytes)
+			{
+				break;
+			}
+			if (Platform::RemoveFile(item.path))
+			{
+				totalBytes -= item.info.size;
+			}
+		}
+	}
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include "common/String.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Helpers for on-disk caches that keep one file per entry. Each file is named
+// after a hash of whatever identifies the entry and starts with a header
+// that says exactly what it holds; a file whose header does not match is
+// treated as missing, which also takes care of names that hash the same.
+namespace CacheFile
+{
+	// 64-bit FNV-1a.
+	uint64_t Hash(const char *data, size_t size);
+	// Hash of data as 16 hex digits.
+	ByteString HashString(const char *data, size_t size);
+	// File name for the entry identified by name.
+	ByteString EntryName(const ByteString &name, const ByteString &extension);
+
+	// Whatever follows header in the file at path, if the file exists and starts with header.
+	std::optional<std::vector<char>> Read(const ByteString &path, const ByteString &header);
+	// Creates dir if needed, then writes header followed by body to path.
+	bool Write(const ByteString &dir, const ByteString &path, const ByteString &header, const char *body, size_t size);
+	// Removes the least recently written files in dir whose names end in
+	// extension until the rest take up no more than maxBytes.
+	void Prune(const ByteString &dir, const ByteString &extension, uint64_t maxBytes);
+}
@@ -43,6 +43,8 @@ namespace Clipboard
 
 	void SerializeClipboard(std::vector<char> &saveData)
 	{
+		// Other builds, including older ones, read saves off the system clipboard too,
+		// so this sticks to the format they all understand
 		std::tie(std::ignore, saveData) = clipboardData->Serialise();
 	}
 
@@ -3,6 +3,7 @@
 #include "common/tpt-rand.h"
 #include "Config.h"
 #include <memory>
+#include <mutex>
 #include <cstring>
 #include <fstream>
 #include <iostream>
@@ -67,6 +68,15 @@ bool ReadFile(std::vector<char> &fileData, ByteString filename)
 	return true;
 }
 
+static unsigned int TempFileSuffix()
+{
+	// WriteFile is also called from worker threads, so interfaceRng is out of the question
+	static std::mutex mx;
+	static RNG rng;
+	std::lock_guard lk(mx);
+	return rng() % 100000;
+}
+
 bool WriteFile(const std::vector<char> &fileData, ByteString filename)
 {
 	auto replace = FileExists(filename);
@@ -75,7 +85,7 @@ bool WriteFile(const std::vector<char> &fileData, ByteString filename)
 	{
 		while (true)
 		{
-			writeFileName = ByteString::Build(filename, ".temp.", Format::Width(5), Format::Fill('0'), interfaceRng() % 100000);
+			writeFileName = ByteString::Build(filename, ".temp.", Format::Width(5), Format::Fill('0'), TempFileSuffix());
 			if (!FileExists(writeFileName))
 			{
 				break;
@@ -18,6 +18,16 @@ namespace Platform
 	long unsigned int GetTime();
 
 	bool Stat(ByteString filename);
+	struct FileInfo
+	{
+		uint64_t size;
+		int64_t modified; // seconds since the epoch
+	};
+	// Empty if filename is not a regular file.
+	std::optional<FileInfo> GetFileInfo(ByteString filename);
+	// Opaque timestamp that changes whenever entries are added to, removed from
+	// or renamed in directory; empty if directory is not a directory.
+	std::optional<int64_t> GetDirectoryModified(ByteString directory);
 	bool FileExists(ByteString filename);
 	bool DirectoryExists(ByteString directory);
 	bool IsLink(ByteString path);
@@ -42,6 +42,31 @@ bool Stat(ByteString filename)
 	}
 }
 
+std::optional<FileInfo> GetFileInfo(ByteString filename)
+{
+	struct stat s;
+	if (stat(filename.c_str(), &s) == 0 && (s.st_mode & S_IFREG))
+	{
+		return FileInfo{ uint64_t(s.st_size), int64_t(s.st_mtime) };
+	}
+	return std::nullopt;
+}
+
+std::optional<int64_t> GetDirectoryModified(ByteString directory)
+{
+	struct stat s;
+	if (stat(directory.c_str(), &s) == 0 && (s.st_mode & S_IFDIR))
+	{
+#ifdef __APPLE__
+		auto &mtime = s.st_mtimespec;
+#else
+		auto &mtime = s.st_mtim;
+#endif
+		return int64_t(mtime.tv_sec) * 1000000000 + int64_t(mtime.tv_nsec);
+	}
+	return std::nullopt;
+}
+
 bool FileExists(ByteString filename)
 {
 	struct stat s;
@@ -55,6 +55,26 @@ bool Stat(ByteString filename)
 	}
 }
 
+std::optional<FileInfo> GetFileInfo(ByteString filename)
+{
+	struct _stat64 s;
+	if (_wstat64(WinWiden(filename).c_str(), &s) == 0 && (s.st_mode & S_IFREG))
+	{
+		return FileInfo{ uint64_t(s.st_size), int64_t(s.st_mtime) };
+	}
+	return std::nullopt;
+}
+
+std::optional<int64_t> GetDirectoryModified(ByteString directory)
+{
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if (GetFileAttributesExW(WinWiden(directory).c_str(), GetFileExInfoStandard, &data) && (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+	{
+		return int64_t((uint64_t(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime);
+	}
+	return std::nullopt;
+}
+
 bool FileExists(ByteString filename)
 {
 	struct _stat s;
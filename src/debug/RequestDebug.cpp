@@ -0,0 +1,58 @@
+#include "RequestDebug.h"
+#include "client/http/requestmanager/RequestManager.h"
+#include "client/http/requestmanager/ResponseCache.h"
+#include "gui/interface/Engine.h"
+#include "graphics/Graphics.h"
+#include "SimulationConfig.h"
+#include <algorithm>
+
+RequestDebug::RequestDebug(unsigned int id):
+	DebugInfo(id)
+{
+
+}
+
+void RequestDebug::Draw()
+{
+	Graphics * g = ui::Engine::Ref().g;
+
+	auto &manager = http::RequestManager::Ref();
+	auto stats = manager.GetStats();
+	auto cacheStats = manager.GetResponseCache().GetStats();
+	String names[] = { "Prefetch", "Bulk", "Interactive" }; // by http::Request::Priority
+	std::vector<String> text;
+	for (auto priority : { http::Request::priorityInteractive, http::Request::priorityBulk, http::Request::priorityPrefetch })
+	{
+		auto &classStats = stats[priority];
+		auto completed = std::max(classStats.completed, 1);
+		auto transferred = classStats.completed - classStats.fromCache;
+		text.push_back(String::Build(
+			names[priority], ": ",
+			classStats.active, " active, ", classStats.queued, " queued, ",
+			classStats.completed, " done, ", classStats.failed, " failed, ", classStats.fromCache, " cached"
+		));
+		text.push_back(String::Build(
+			"  avg ", Format::Precision(1000.0 * classStats.totalSeconds / completed, 0), "ms",
+			" (queued ", Format::Precision(1000.0 * classStats.queueSeconds / std::max(transferred, 1), 0), "ms), ",
+			classStats.bytes / 1024, "KiB at ",
+			Format::Precision(classStats.transferSeconds > 0 ? classStats.bytes / 1024.0 / classStats.transferSeconds : 0.0, 0), "KiB/s per transfer"
+		));
+	}
+	text.push_back(String::Build(
+		"Cache: ", cacheStats.hits, " hits, ", cacheStats.revalidated, " revalidated, ",
+		cacheStats.stores, " stored, ", cacheStats.evictions, " evicted"
+	));
+
+	int width = 0;
+	for (auto &str : text)
+	{
+		width = std::max(width, g->TextSize(str).X);
+	}
+	int x = XRES - width - 10, y = 30;
+	g->BlendFilledRect(RectSized(Vec2{ x - 3, y - 3 }, Vec2{ width + 6, int(text.size()) * 12 + 4 }), 0x000000_rgb .WithAlpha(180));
+	for (auto &str : text)
+	{
+		g->BlendText({ x, y }, str, 0xFFFFFF_rgb .WithAlpha(255));
+		y += 12;
+	}
+}
@@ -0,0 +1,9 @@
+#pragma once
+#include "DebugInfo.h"
+
+class RequestDebug : public DebugInfo
+{
+public:
+	RequestDebug(unsigned int id);
+	void Draw() override;
+};
@@ -0,0 +1,202 @@
+#include "DisplayList.h"
+#include "common/RasterGeometry.h"
+#include "FontReader.h"
+#include "Graphics.h"
+#include "Renderer.h"
+#include "TextLayout.h"
+#include <algorithm>
+#include <utility>
+
+int DisplayList::Add(Item item)
+{
+	entries.emplace_back();
+	entries.back().item = std::move(item);
+	return int(entries.size()) - 1;
+}
+
+void DisplayList::Remove(int index)
+{
+	entries[index] = Entry();
+}
+
+void DisplayList::Clear()
+{
+	entries.clear();
+}
+
+void DisplayList::Set(int index, Item item)
+{
+	auto &entry = entries[index];
+	auto &old = entry.item;
+	if (item.kind != old.kind || item.size != old.size || item.colour.Pack() != old.colour.Pack() || item.text != old.text)
+	{
+		entry.dirty = true;
+		entry.spans.clear();
+	}
+	old = std::move(item);
+}
+
+// Merges points into horizontal spans of the same colour. Of points drawn
+// more than once, those drawn over by an opaque point later are dropped;
+// blended ones that remain are all drawn, in their original order, as
+// blending them into each other is not the same as blending only the last.
+static void pointsToSpans(std::vector<std::pair<Vec2<int>, RGBA<uint8_t>>> &points, std::vector<DisplayList::Span> &spans)
+{
+	std::stable_sort(points.begin(), points.end(), [](auto &lhs, auto &rhs) {
+		return std::pair(lhs.first.Y, lhs.first.X) < std::pair(rhs.first.Y, rhs.first.X);
+	});
+	size_t runEnd = 0;
+	size_t lastOpaque = 0;
+	for (size_t i = 0; i < points.size(); i++)
+	{
+		if (i == runEnd)
+		{
+			// Find the run of identical positions starting here, and the last opaque point in it
+			lastOpaque = i;
+			for (runEnd = i; runEnd < points.size() && points[runEnd].first == points[i].first; runEnd++)
+			{
+				if (points[runEnd].second.Alpha == 255)
+				{
+					lastOpaque = runEnd;
+				}
+			}
+		}
+		if (i < lastOpaque)
+		{
+			continue;
+		}
+		auto [ pos, colour ] = points[i];
+		if (spans.size())
+		{
+			auto &last = spans.back().rect;
+			if (last.TopLeft.Y == pos.Y && last.BottomRight.X + 1 == pos.X && spans.back().colour.Pack() == colour.Pack())
+			{
+				last.BottomRight.X = pos.X;
+				continue;
+			}
+		}
+		spans.push_back({ RectBetween(pos, pos), colour });
+	}
+}
+
+void DisplayList::Rasterize(Entry &entry)
+{
+	auto &item = entry.item;
+	auto &spans = entry.spans;
+	spans.clear();
+	std::vector<std::pair<Vec2<int>, RGBA<uint8_t>>> points;
+	auto colour = item.colour;
+	auto origin = Vec2(0, 0);
+	switch (item.kind)
+	{
+	case kindNone:
+		break;
+
+	case kindText:
+		{
+			auto const &layout = TextLayout::Get(item.text);
+			for (auto const &glyphItem : layout.items)
+			{
+				auto const c = glyphItem.Colour(colour.NoAlpha());
+				auto const glyphOrigin = glyphItem.pos + Vec2(0, -2);
+				for (auto off : RectSized(Vec2(0, 0), Vec2(glyphItem.glyph->Width, FONT_H)))
+				{
+					if (auto level = glyphItem.glyph->Alpha[off.X + off.Y * glyphItem.glyph->Width])
+					{
+						points.push_back({ glyphOrigin + off, c.WithAlpha(level * colour.Alpha / 3) });
+					}
+				}
+				if (glyphItem.underline)
+				{
+					for (int i = 0; i < glyphItem.glyph->Width; i++)
+					{
+						points.push_back({ glyphItem.pos + Vec2(i, FONT_H), c.WithAlpha(colour.Alpha) });
+					}
+				}
+			}
+			entry.glyphGeneration = FontReader::GlyphGeneration();
+		}
+		break;
+
+	case kindPixel:
+		spans.push_back({ RectSized(origin, Vec2(1, 1)), colour });
+		break;
+
+	case kindLine:
+		RasterizeLine<false>(origin, item.size, [&points, colour](Vec2<int> pos) {
+			points.push_back({ pos, colour });
+		});
+		break;
+
+	case kindRect:
+		RasterizeRect(RectSized(origin, item.size), [&points, colour](Vec2<int> pos) {
+			points.push_back({ pos, colour });
+		});
+		break;
+
+	case kindFilledRect:
+		spans.push_back({ RectSized(origin, item.size), colour });
+		break;
+
+	case kindEllipse:
+		{
+			auto size = Vec2(std::abs(item.size.X), std::abs(item.size.Y));
+			RasterizeEllipsePoints(Vec2(float(size.X * size.X), float(size.Y * size.Y)), [&points, colour](Vec2<int> delta) {
+				points.push_back({ delta, colour });
+			});
+		}
+		break;
+
+	case kindFilledEllipse:
+		{
+			auto size = Vec2(std::abs(item.size.X), std::abs(item.size.Y));
+			RasterizeEllipseRows(Vec2(float(size.X * size.X), float(size.Y * size.Y)), [&spans, colour](int xLim, int dy) {
+				spans.push_back({ RectBetween(Vec2(-xLim, dy), Vec2(xLim, dy)), colour });
+			});
+		}
+		break;
+	}
+	pointsToSpans(points, spans);
+	// Fully transparent spans would leave the target unchanged
+	spans.erase(std::remove_if(spans.begin(), spans.end(), [](auto &span) {
+		return !span.colour.Alpha;
+	}), spans.end());
+	entry.dirty = false;
+}
+
+template<class Target>
+void DisplayList::Draw(Target &target, Vec2<int> offset)
+{
+	for (auto &entry : entries)
+	{
+		auto &item = entry.item;
+		if (item.kind == kindNone || !item.visible)
+		{
+			continue;
+		}
+		if (item.kind == kindText && entry.glyphGeneration != FontReader::GlyphGeneration())
+		{
+			entry.dirty = true;
+		}
+		if (entry.dirty)
+		{
+			Rasterize(entry);
+		}
+		auto origin = item.pos + offset;
+		for (auto &span : entry.spans)
+		{
+			auto rect = RectBetween(span.rect.TopLeft + origin, span.rect.BottomRight + origin);
+			if (span.colour.Alpha == 255)
+			{
+				target.DrawFilledRect(rect, span.colour.NoAlpha());
+			}
+			else
+			{
+				target.BlendFilledRect(rect, span.colour);
+			}
+		}
+	}
+}
+
+template void DisplayList::Draw<Graphics>(Graphics &, Vec2<int>);
+template void DisplayList::Draw<Renderer>(Renderer &, Vec2<int>);
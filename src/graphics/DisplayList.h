@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "common/String.h"
+#include "common/Vec2.h"
+#include "Pixel.h"
+
+// A retained list of primitives that is drawn in one go. Each item is
+// rasterised once into rectangles of uniform colour, relative to its position,
+// and only rasterised again when something other than its position changes,
+// so drawing the list amounts to a series of clipped span fills.
+class DisplayList
+{
+public:
+	enum Kind
+	{
+		kindNone, // removed item
+		kindText,
+		kindPixel,
+		kindLine,
+		kindRect,
+		kindFilledRect,
+		kindEllipse,
+		kindFilledEllipse,
+	};
+
+	struct Item
+	{
+		Kind kind = kindNone;
+		Vec2<int> pos = Vec2(0, 0);
+		// Size for rects, other end relative to pos for lines, radii for ellipses
+		Vec2<int> size = Vec2(0, 0);
+		RGBA<uint8_t> colour = 0xFFFFFF_rgb .WithAlpha(255);
+		String text;
+		bool visible = true;
+	};
+
+	struct Span
+	{
+		Rect<int> rect;
+		RGBA<uint8_t> colour;
+	};
+
+private:
+	struct Entry
+	{
+		Item item;
+		bool dirty = true;
+		uint32_t glyphGeneration = 0;
+		std::vector<Span> spans;
+	};
+
+	std::vector<Entry> entries;
+
+	static void Rasterize(Entry &entry);
+
+public:
+	// Returns the index of the new item.
+	int Add(Item item);
+	void Remove(int index);
+	void Clear();
+
+	int Size() const
+	{
+		return int(entries.size());
+	}
+
+	Item const &Get(int index) const
+	{
+		return entries[index].item;
+	}
+
+	// Items only need to be rasterised again if anything but pos changed.
+	void Set(int index, Item item);
+
+	template<class Target>
+	void Draw(Target &target, Vec2<int> offset);
+};
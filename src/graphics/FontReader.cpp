@@ -4,12 +4,31 @@
 #include "font.bz2.h"
 
 #include <array>
+#include <atomic>
 #include <cstdint>
+#include <mutex>
 
 unsigned char *font_data = nullptr;
 unsigned int *font_ptrs = nullptr;
 unsigned int (*font_ranges)[2] = nullptr;
 
+namespace
+{
+	struct GlyphAtlas
+	{
+		std::vector<unsigned char> alpha;
+		std::vector<FontGlyph> glyphs; // same order as font_ptrs
+		std::array<FontGlyph const *, 0x100> low; // direct lookup for the most common characters
+		FontGlyph const *replacement;
+	};
+
+	GlyphAtlas atlas;
+	FontGlyph const emptyGlyph = { 0, nullptr };
+	std::mutex atlasMx;
+	std::atomic<bool> atlasValid = false;
+	std::atomic<uint32_t> atlasGeneration = 0;
+}
+
 FontReader::FontReader(unsigned char const *_pointer):
 	pointer(_pointer + 1),
 	width(*_pointer),
@@ -126,3 +145,100 @@ int FontReader::NextPixel()
 	data >>= 2;
 	return old & 0x3;
 }
+
+static FontGlyph const *findGlyph(String::value_type ch)
+{
+	size_t offset = 0;
+	for (int i = 0; font_ranges[i][1]; i++)
+		if (font_ranges[i][0] > ch)
+			break;
+		else if (font_ranges[i][1] >= ch)
+			return &atlas.glyphs[offset + (ch - font_ranges[i][0])];
+		else
+			offset += font_ranges[i][1] - font_ranges[i][0] + 1;
+	return nullptr;
+}
+
+void FontReader::buildAtlas()
+{
+	if (!font_data)
+	{
+		if (!InitFontData())
+		{
+			throw std::runtime_error("font data corrupt");
+		}
+	}
+	size_t glyphCount = 0;
+	for (int i = 0; font_ranges[i][1]; i++)
+	{
+		glyphCount += font_ranges[i][1] - font_ranges[i][0] + 1;
+	}
+	size_t alphaSize = 0;
+	for (size_t i = 0; i < glyphCount; i++)
+	{
+		alphaSize += font_data[font_ptrs[i]] * FONT_H;
+	}
+	atlas.alpha.assign(alphaSize, 0);
+	atlas.glyphs.resize(glyphCount);
+	size_t offset = 0;
+	for (size_t i = 0; i < glyphCount; i++)
+	{
+		FontReader reader(&font_data[font_ptrs[i]]);
+		auto size = reader.GetWidth() * FONT_H;
+		for (int j = 0; j < size; j++)
+		{
+			atlas.alpha[offset + j] = reader.NextPixel();
+		}
+		atlas.glyphs[i] = { reader.GetWidth(), atlas.alpha.data() + offset };
+		offset += size;
+	}
+	atlas.replacement = findGlyph(0xFFFD);
+	if (!atlas.replacement)
+	{
+		atlas.replacement = &emptyGlyph;
+	}
+	for (String::value_type ch = 0; ch < atlas.low.size(); ch++)
+	{
+		auto *glyph = findGlyph(ch);
+		atlas.low[ch] = glyph ? glyph : atlas.replacement;
+	}
+}
+
+void FontReader::ensureAtlas()
+{
+	if (!atlasValid.load(std::memory_order_acquire))
+	{
+		std::lock_guard lk(atlasMx);
+		if (!atlasValid.load(std::memory_order_relaxed))
+		{
+			buildAtlas();
+			atlasGeneration++;
+			atlasValid.store(true, std::memory_order_release);
+		}
+	}
+}
+
+FontGlyph const &FontReader::LookupGlyph(String::value_type ch)
+{
+	ensureAtlas();
+	if (ch < atlas.low.size())
+	{
+		return *atlas.low[ch];
+	}
+	if (auto *glyph = findGlyph(ch))
+	{
+		return *glyph;
+	}
+	return *atlas.replacement;
+}
+
+void FontReader::InvalidateGlyphs()
+{
+	atlasValid.store(false, std::memory_order_release);
+}
+
+uint32_t FontReader::GlyphGeneration()
+{
+	ensureAtlas();
+	return atlasGeneration.load(std::memory_order_relaxed);
+}
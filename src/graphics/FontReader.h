@@ -1,10 +1,19 @@
 #pragma once
 #include <cstddef>
+#include <cstdint>
 
 #include "common/String.h"
 
 constexpr auto FONT_H = 12;
 
+// A glyph expanded from the packed font data: FONT_H rows of Width pixels,
+// row-major, one alpha level (0 to 3) per byte.
+struct FontGlyph
+{
+	int Width;
+	unsigned char const *Alpha;
+};
+
 class FontReader
 {
 	unsigned char const *pointer;
@@ -14,9 +23,20 @@ class FontReader
 
 	FontReader(unsigned char const *_pointer);
 	static unsigned char const *lookupChar(String::value_type ch);
+	static void buildAtlas();
+	static void ensureAtlas();
 
 public:
 	FontReader(String::value_type ch);
 	int GetWidth() const;
 	int NextPixel();
+
+	// Glyphs are expanded into the atlas all at once on first use; the
+	// returned reference stays valid until InvalidateGlyphs is called.
+	static FontGlyph const &LookupGlyph(String::value_type ch);
+	// Call after changing font_data, font_ptrs or font_ranges.
+	static void InvalidateGlyphs();
+	// Changes every time the atlas is rebuilt, for caches that hold on to
+	// FontGlyph pointers.
+	static uint32_t GlyphGeneration();
 };
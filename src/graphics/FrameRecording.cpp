@@ -0,0 +1,224 @@
+#include "FrameRecording.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <zlib.h>
+
+constexpr std::array<char, 8> recordingMagic = { 'T', 'P', 'T', 'R', 'E', 'C', 0, 0 };
+constexpr uint32_t recordingVersion = 1;
+constexpr uint32_t maxFrameSize = 0x10000000U;
+
+enum RecordingFrameType
+{
+	recordingKeyframe,
+	recordingDelta,
+};
+
+static void PutU32(std::vector<char> &data, uint32_t value)
+{
+	for (int i = 0; i < 4; i++)
+		data.push_back(char((value >> (i * 8)) & 0xFF));
+}
+
+static void PutVarint(std::vector<char> &data, uint32_t value)
+{
+	while (value >= 0x80)
+	{
+		data.push_back(char((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	data.push_back(char(value));
+}
+
+static void PutPixels(std::vector<char> &data, pixel const *begin, pixel const *end)
+{
+	for (auto *px = begin; px != end; px++)
+	{
+		auto colour = RGB<uint8_t>::Unpack(*px);
+		data.push_back(char(colour.Red));
+		data.push_back(char(colour.Green));
+		data.push_back(char(colour.Blue));
+	}
+}
+
+namespace
+{
+	struct Reader
+	{
+		std::vector<char> const &data;
+		size_t pos = 0;
+
+		void Need(size_t size) const
+		{
+			if (data.size() - pos < size)
+				throw std::runtime_error("truncated frame");
+		}
+
+		uint32_t U32()
+		{
+			Need(4);
+			uint32_t value = 0;
+			for (int i = 0; i < 4; i++)
+				value |= uint32_t(uint8_t(data[pos + i])) << (i * 8);
+			pos += 4;
+			return value;
+		}
+
+		uint32_t Varint()
+		{
+			uint32_t value = 0;
+			for (int shift = 0; shift < 32; shift += 7)
+			{
+				Need(1);
+				auto byte = uint8_t(data[pos++]);
+				value |= uint32_t(byte & 0x7F) << shift;
+				if (!(byte & 0x80))
+					return value;
+			}
+			throw std::runtime_error("bad varint");
+		}
+
+		void Pixels(pixel *begin, pixel *end)
+		{
+			Need((end - begin) * 3);
+			for (auto *px = begin; px != end; px++, pos += 3)
+				*px = RGB<uint8_t>(uint8_t(data[pos]), uint8_t(data[pos + 1]), uint8_t(data[pos + 2])).Pack();
+		}
+	};
+}
+
+RecordingEncoder::RecordingEncoder(int newKeyframeInterval):
+	keyframeInterval(std::max(newKeyframeInterval, 1))
+{
+}
+
+std::vector<char> RecordingEncoder::Header() const
+{
+	std::vector<char> data(recordingMagic.begin(), recordingMagic.end());
+	PutU32(data, recordingVersion);
+	PutU32(data, keyframeInterval);
+	return data;
+}
+
+std::vector<char> RecordingEncoder::Encode(const VideoBuffer &frame)
+{
+	auto size = frame.Size();
+	auto count = size_t(size.X) * size.Y;
+	auto *pixels = frame.Data();
+	std::vector<char> raw;
+	RecordingFrameType type;
+	if (!previous || previous->Size() != size || sinceKeyframe >= keyframeInterval)
+	{
+		type = recordingKeyframe;
+		raw.reserve(8 + count * 3);
+		PutU32(raw, size.X);
+		PutU32(raw, size.Y);
+		PutPixels(raw, pixels, pixels + count);
+		previous = std::make_unique<VideoBuffer>(frame);
+		sinceKeyframe = 1;
+	}
+	else
+	{
+		type = recordingDelta;
+		auto *old = previous->Data();
+		size_t last = 0;
+		size_t i = 0;
+		while (i < count)
+		{
+			if (pixels[i] == old[i])
+			{
+				i++;
+				continue;
+			}
+			auto begin = i;
+			while (i < count && pixels[i] != old[i])
+				i++;
+			PutVarint(raw, uint32_t(begin - last));
+			PutVarint(raw, uint32_t(i - begin));
+			PutPixels(raw, pixels + begin, pixels + i);
+			std::copy(pixels + begin, pixels + i, old + begin);
+			last = i;
+		}
+		sinceKeyframe++;
+	}
+
+	auto bound = compressBound(raw.size());
+	std::vector<char> data(9 + bound);
+	data[0] = char(type);
+	auto compressedSize = uLongf(bound);
+	if (compress2(reinterpret_cast<Bytef *>(&data[9]), &compressedSize, reinterpret_cast<const Bytef *>(raw.data()), raw.size(), Z_BEST_SPEED) != Z_OK)
+		throw std::runtime_error("deflate failed");
+	data.resize(9 + compressedSize);
+	std::vector<char> sizes;
+	PutU32(sizes, uint32_t(compressedSize));
+	PutU32(sizes, uint32_t(raw.size()));
+	std::copy(sizes.begin(), sizes.end(), &data[1]);
+	return data;
+}
+
+void RecordingDecoder::ReadHeader(std::istream &stream)
+{
+	std::vector<char> header(recordingMagic.size() + 8);
+	if (!stream.read(header.data(), header.size()) || !std::equal(recordingMagic.begin(), recordingMagic.end(), header.begin()))
+		throw std::runtime_error("not a recording");
+	Reader reader{ header, recordingMagic.size() };
+	if (reader.U32() != recordingVersion)
+		throw std::runtime_error("unsupported recording version");
+	current.reset();
+}
+
+VideoBuffer const *RecordingDecoder::Next(std::istream &stream)
+{
+	std::vector<char> head(9);
+	stream.read(head.data(), 1);
+	if (stream.gcount() == 0)
+		return nullptr;
+	if (!stream.read(&head[1], 8))
+		throw std::runtime_error("truncated frame");
+	auto type = RecordingFrameType(uint8_t(head[0]));
+	Reader headReader{ head, 1 };
+	auto compressedSize = headReader.U32();
+	auto rawSize = headReader.U32();
+	if (compressedSize > maxFrameSize || rawSize > maxFrameSize)
+		throw std::runtime_error("frame too large");
+	std::vector<char> compressed(compressedSize);
+	if (!stream.read(compressed.data(), compressed.size()))
+		throw std::runtime_error("truncated frame");
+	std::vector<char> raw(rawSize);
+	auto inflatedSize = uLongf(rawSize);
+	if (uncompress(reinterpret_cast<Bytef *>(raw.data()), &inflatedSize, reinterpret_cast<const Bytef *>(compressed.data()), compressed.size()) != Z_OK || inflatedSize != rawSize)
+		throw std::runtime_error("inflate failed");
+
+	Reader reader{ raw };
+	if (type == recordingKeyframe)
+	{
+		auto width = int(reader.U32());
+		auto height = int(reader.U32());
+		if (width <= 0 || height <= 0 || uint64_t(width) * height * 3 > maxFrameSize)
+			throw std::runtime_error("bad keyframe size");
+		current = std::make_unique<VideoBuffer>(Vec2(width, height));
+		reader.Pixels(current->Data(), current->Data() + size_t(width) * height);
+	}
+	else if (type == recordingDelta)
+	{
+		if (!current)
+			throw std::runtime_error("delta frame without keyframe");
+		auto count = size_t(current->Size().X) * current->Size().Y;
+		size_t pos = 0;
+		while (reader.pos < raw.size())
+		{
+			pos += reader.Varint();
+			auto length = reader.Varint();
+			if (pos > count || count - pos < length)
+				throw std::runtime_error("delta run out of bounds");
+			reader.Pixels(current->Data() + pos, current->Data() + pos + length);
+			pos += length;
+		}
+	}
+	else
+	{
+		throw std::runtime_error("unknown frame type");
+	}
+	return current.get();
+}
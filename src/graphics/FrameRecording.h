@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <vector>
+#include "Graphics.h"
+
+// A container for frame sequences in which consecutive frames differ by only
+// a few pixels, such as subframe recordings. Every keyframeInterval-th frame
+// is stored whole, the others as runs of pixels that changed since the
+// previous frame. Each frame record is deflated separately.
+//
+// Layout, integers little-endian:
+//   header:   "TPTREC\0\0", u32 version, u32 keyframeInterval
+//   frame:    u8 type, u32 compressed size, u32 raw size, deflated payload
+//   keyframe: u32 width, u32 height, then width * height RGB triplets
+//   delta:    any number of { varint skip, varint length, length RGB triplets }
+constexpr char RECORDING_EXTENSION[] = ".tptrec";
+
+class RecordingEncoder
+{
+	int keyframeInterval;
+	int sinceKeyframe = 0;
+	std::unique_ptr<VideoBuffer> previous;
+
+public:
+	RecordingEncoder(int newKeyframeInterval);
+
+	std::vector<char> Header() const;
+	std::vector<char> Encode(const VideoBuffer &frame);
+};
+
+class RecordingDecoder
+{
+	std::unique_ptr<VideoBuffer> current;
+
+public:
+	// Both throw std::runtime_error on malformed input.
+	void ReadHeader(std::istream &stream);
+	// Returns nullptr at the end of the stream. The frame stays valid until
+	// the next call.
+	VideoBuffer const *Next(std::istream &stream);
+};
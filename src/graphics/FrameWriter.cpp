@@ -0,0 +1,187 @@
+#include "FrameWriter.h"
+#include "FrameRecording.h"
+#include "common/platform/Platform.h"
+
+FrameWriter::FrameWriter(ByteString newPrefix, Codec newCodec, size_t newCapacity, int keyframeInterval):
+	prefix(newPrefix),
+	codec(newCodec),
+	capacity(std::max(newCapacity, size_t(1)))
+{
+	stats.capacity = capacity;
+	if (codec == codecDelta)
+	{
+		encoder = std::make_unique<RecordingEncoder>(keyframeInterval);
+		stream.open(prefix + RECORDING_EXTENSION, std::ios::binary);
+		auto header = encoder->Header();
+		if (!stream.write(header.data(), header.size()))
+		{
+			error = "cannot write " + prefix + RECORDING_EXTENSION;
+		}
+	}
+	thread = std::thread([this]() {
+		Run();
+	});
+}
+
+FrameWriter::~FrameWriter()
+{
+	Finish();
+}
+
+void FrameWriter::Finish()
+{
+	{
+		std::lock_guard lk(mx);
+		stopping = true;
+	}
+	cv.notify_all();
+	if (thread.joinable())
+	{
+		thread.join();
+	}
+}
+
+void FrameWriter::Push(VideoBuffer frame)
+{
+	std::unique_lock lk(mx);
+	if (error)
+	{
+		return;
+	}
+	if (queue.size() >= capacity)
+	{
+		auto start = Platform::GetTime();
+		cv.wait(lk, [this]() {
+			return queue.size() < capacity;
+		});
+		stats.stalls += 1;
+		stats.stallMs += Platform::GetTime() - start;
+	}
+	queue.push_back(std::move(frame));
+	stats.pushed += 1;
+	stats.queued = queue.size();
+	lk.unlock();
+	cv.notify_all();
+}
+
+FrameWriter::Stats FrameWriter::GetStats()
+{
+	std::lock_guard lk(mx);
+	return stats;
+}
+
+std::optional<ByteString> FrameWriter::GetError()
+{
+	std::lock_guard lk(mx);
+	return error;
+}
+
+std::optional<FrameWriter::Codec> FrameWriter::CodecFromName(ByteString name)
+{
+	if (name == "ppm")
+	{
+		return codecPPM;
+	}
+	if (name == "png")
+	{
+		return codecPNG;
+	}
+	if (name == "delta")
+	{
+		return codecDelta;
+	}
+	return std::nullopt;
+}
+
+bool FrameWriter::Write(const VideoBuffer &frame, uint64_t index, uint64_t &bytes)
+{
+	switch (codec)
+	{
+	case codecPPM:
+	case codecPNG:
+		{
+			std::vector<char> data;
+			if (codec == codecPPM)
+			{
+				data = frame.ToPPM();
+			}
+			else if (auto png = frame.ToPNG())
+			{
+				data = std::move(*png);
+			}
+			else
+			{
+				return false;
+			}
+			bytes = data.size();
+			auto filename = ByteString::Build(prefix, "_", Format::Width(index, 6), codec == codecPPM ? ".ppm" : ".png");
+			return Platform::WriteFile(data, filename);
+		}
+
+	case codecDelta:
+		{
+			auto data = encoder->Encode(frame);
+			bytes = data.size();
+			return bool(stream.write(data.data(), data.size()));
+		}
+	}
+	return false;
+}
+
+void FrameWriter::Run()
+{
+	uint64_t index = 0;
+	std::unique_lock lk(mx);
+	while (true)
+	{
+		cv.wait(lk, [this]() {
+			return stopping || !queue.empty();
+		});
+		if (queue.empty())
+		{
+			break;
+		}
+		auto frame = std::move(queue.front());
+		queue.pop_front();
+		auto failed = bool(error);
+		lk.unlock();
+		cv.notify_all();
+
+		uint64_t bytes = 0;
+		bool ok = false;
+		ByteString failure = ByteString::Build("failed to write frame ", index);
+		if (!failed)
+		{
+			try
+			{
+				ok = Write(frame, index, bytes);
+			}
+			catch (const std::exception &e)
+			{
+				failure += ByteString(": ") + e.what();
+			}
+		}
+
+		lk.lock();
+		stats.queued = queue.size();
+		if (ok)
+		{
+			stats.written += 1;
+			stats.bytesWritten += bytes;
+		}
+		else if (!error)
+		{
+			error = failure;
+		}
+		index += 1;
+	}
+	if (stream.is_open())
+	{
+		// Whatever was still buffered is written here
+		stream.close();
+		if (!stream && !error)
+		{
+			error = "cannot write " + prefix + RECORDING_EXTENSION;
+		}
+	}
+}
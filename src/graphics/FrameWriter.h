@@ -0,0 +1,72 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include "common/String.h"
+#include "Graphics.h"
+
+class RecordingEncoder;
+
+// Encodes and writes frames on a background thread so that whoever produces
+// them only waits if the writer falls more than a queue's worth behind.
+class FrameWriter
+{
+public:
+	enum Codec
+	{
+		codecPPM, // prefix_NNNNNN.ppm
+		codecPNG, // prefix_NNNNNN.png
+		codecDelta, // prefix.tptrec, see FrameRecording.h
+	};
+
+	struct Stats
+	{
+		size_t queued = 0;
+		size_t capacity = 0;
+		uint64_t pushed = 0;
+		uint64_t written = 0;
+		uint64_t bytesWritten = 0;
+		// Number of Push calls that had to wait for the queue to drain
+		uint64_t stalls = 0;
+		uint64_t stallMs = 0;
+	};
+
+private:
+	ByteString prefix;
+	Codec codec;
+	size_t capacity;
+	std::unique_ptr<RecordingEncoder> encoder;
+	std::ofstream stream;
+
+	std::mutex mx;
+	std::condition_variable cv;
+	std::deque<VideoBuffer> queue;
+	bool stopping = false;
+	Stats stats;
+	std::optional<ByteString> error;
+	std::thread thread;
+
+	void Run();
+	bool Write(const VideoBuffer &frame, uint64_t index, uint64_t &bytes);
+
+public:
+	FrameWriter(ByteString newPrefix, Codec newCodec, size_t newCapacity = 16, int keyframeInterval = 300);
+	// Calls Finish.
+	~FrameWriter();
+
+	void Push(VideoBuffer frame);
+	// Waits for queued frames to be written and stops the thread; check
+	// GetError after this to know whether everything made it to disk. No
+	// more frames may be pushed.
+	void Finish();
+	Stats GetStats();
+	// Set once a frame fails to be written; frames pushed afterwards are dropped.
+	std::optional<ByteString> GetError();
+
+	static std::optional<Codec> CodecFromName(ByteString name);
+};
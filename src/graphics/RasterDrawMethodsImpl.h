@@ -1,9 +1,11 @@
+#include <array>
 #include <cmath>
 #include <cstring>
 #include "common/RasterGeometry.h"
 #include "FontReader.h"
 #include "Graphics.h"
 #include "RasterDrawMethods.h"
+#include "TextLayout.h"
 
 #define clipRect() (static_cast<Derived const &>(*this).GetClipRect())
 
@@ -31,6 +33,25 @@ static inline void xorPixelUnchecked(RasterDrawMethods<Derived> &self, V Derived
 		px = 0x404040_rgb .Pack();
 }
 
+template<typename Derived, typename V>
+static inline void blendGlyphClipped(RasterDrawMethods<Derived> &self, V Derived::*video, Rect<int> clip, Vec2<int> pos, FontGlyph const &glyph, RGBA<uint8_t> colour)
+{
+	auto const origin = pos + Vec2(0, -2);
+	auto const c = colour.NoAlpha();
+	std::array<RGBA<uint8_t>, 4> const levels = {
+		c.WithAlpha(0),
+		c.WithAlpha(1 * colour.Alpha / 3),
+		c.WithAlpha(2 * colour.Alpha / 3),
+		c.WithAlpha(3 * colour.Alpha / 3),
+	};
+	for (auto off : RectSized(origin, Vec2(glyph.Width, FONT_H)) & clip)
+	{
+		// Blending with zero alpha leaves the pixel unchanged
+		if (auto level = glyph.Alpha[(off.X - origin.X) + (off.Y - origin.Y) * glyph.Width])
+			blendPixelUnchecked(self, video, off, levels[level]);
+	}
+}
+
 template<typename Derived>
 inline void RasterDrawMethods<Derived>::DrawPixel(Vec2<int> pos, RGB<uint8_t> colour)
 {
@@ -231,88 +252,37 @@ void RasterDrawMethods<Derived>::BlendRGBAImage(pixel_rgba const *data, Rect<int
 template<typename Derived>
 int RasterDrawMethods<Derived>::BlendChar(Vec2<int> pos, String::value_type ch, RGBA<uint8_t> colour)
 {
-	FontReader reader(ch);
-	auto const rect = RectSized(Vec2(0, -2), Vec2(reader.GetWidth(), FONT_H));
-	for (auto off : rect.template Range<TOP_TO_BOTTOM, LEFT_TO_RIGHT>())
-		BlendPixel(pos + off, colour.NoAlpha().WithAlpha(reader.NextPixel() * colour.Alpha / 3));
-	return reader.GetWidth();
+	auto const &glyph = FontReader::LookupGlyph(ch);
+	blendGlyphClipped(*this, &Derived::video, clipRect(), pos, glyph, colour);
+	return glyph.Width;
 }
 
 template<typename Derived>
 int RasterDrawMethods<Derived>::AddChar(Vec2<int> pos, String::value_type ch, RGBA<uint8_t> colour)
 {
-	FontReader reader(ch);
+	auto const &glyph = FontReader::LookupGlyph(ch);
 	RGB<uint8_t> const c = colour.NoAlpha();
-	auto const rect = RectSized(Vec2(0, -2), Vec2(reader.GetWidth(), FONT_H));
+	auto const rect = RectSized(Vec2(0, -2), Vec2(glyph.Width, FONT_H));
 	for (auto off : rect.template Range<TOP_TO_BOTTOM, LEFT_TO_RIGHT>())
-		AddPixel(pos + off, c.WithAlpha(reader.NextPixel() * colour.Alpha / 3));
-	return reader.GetWidth();
+		AddPixel(pos + off, c.WithAlpha(glyph.Alpha[off.X + (off.Y + 2) * glyph.Width] * colour.Alpha / 3));
+	return glyph.Width;
 }
 
 template<typename Derived>
 Vec2<int> RasterDrawMethods<Derived>::BlendText(Vec2<int> orig_pos, String const &str, RGBA<uint8_t> orig_colour)
 {
-	bool underline = false;
-	bool invert = false;
-	RGB<uint8_t> colour = orig_colour.NoAlpha();
-	uint8_t alpha = orig_colour.Alpha;
-	Vec2<int> pos = orig_pos;
-	for (size_t i = 0; i < str.length(); i++)
+	auto const &layout = TextLayout::Get(str);
+	RGB<uint8_t> const base = orig_colour.NoAlpha();
+	uint8_t const alpha = orig_colour.Alpha;
+	for (auto const &item : layout.items)
 	{
-		if (str[i] == '\n')
-		{
-			pos.X = orig_pos.X;
-			pos.Y += FONT_H;
-		}
-		else if (str[i] == '\x0F')
-		{
-			if (str.length() <= i + 3)
-				break;
-			colour.Red = str[i + 1];
-			colour.Green = str[i + 2];
-			colour.Blue = str[i + 3];
-			i += 3;
-		}
-		else if (str[i] == '\x0E')
-		{
-			colour = orig_colour.NoAlpha();
-		}
-		else if (str[i] == '\x01')
-		{
-			invert = !invert;
-			colour = colour.Inverse();
-		}
-		else if (str[i] == '\b')
-		{
-			if (str.length() <= i + 1)
-				break;
-			bool colourCode = true;
-			switch (str[i + 1])
-			{
-			case 'U': underline = !underline; colourCode = false; break;
-			case 'w': colour = 0xFFFFFF_rgb; break;
-			case 'g': colour = 0xC0C0C0_rgb; break;
-			case 'o': colour = 0xFFD820_rgb; break;
-			case 'r': colour = 0xFF0000_rgb; break;
-			case 'l': colour = 0xFF4B4B_rgb; break;
-			case 'b': colour = 0x0000FF_rgb; break;
-			case 't': colour = 0x20AAFF_rgb; break;
-			case 'u': colour = 0x9353D3_rgb; break;
-			}
-			if (colourCode && invert)
-				colour = colour.Inverse();
-			i++;
-		}
-		else
-		{
-			int dx = BlendChar(pos, str[i], colour.WithAlpha(alpha));
-			if (underline)
-				for (int i = 0; i < dx; i++)
-					BlendPixel(pos + Vec2(i, FONT_H), colour.WithAlpha(alpha));
-			pos.X += dx;
-		}
+		auto const colour = item.Colour(base).WithAlpha(alpha);
+		blendGlyphClipped(*this, &Derived::video, clipRect(), orig_pos + item.pos, *item.glyph, colour);
+		if (item.underline)
+			for (int i = 0; i < item.glyph->Width; i++)
+				BlendPixel(orig_pos + item.pos + Vec2(i, FONT_H), colour);
 	}
-	return pos - orig_pos;
+	return layout.end;
 }
 
 template<typename Derived>
@@ -336,43 +306,13 @@ void RasterDrawMethods<Derived>::Clear()
 template<typename Derived>
 int RasterDrawMethods<Derived>::CharWidth(String::value_type ch)
 {
-	return FontReader(ch).GetWidth();
+	return FontReader::LookupGlyph(ch).Width;
 }
 
 template<typename Derived>
 Vec2<int> RasterDrawMethods<Derived>::TextSize(String const &str)
 {
-	Vec2<int> size = Vec2(0, FONT_H - 2);
-	int curX = 0; // characters have 1px of spacing between them
-	for (size_t i = 0; i < str.length(); i++)
-	{
-		if (str[i] == '\n')
-		{
-			size.X = std::max(curX, size.X);
-			size.Y += FONT_H;
-			curX = 0;
-		}
-		else if (str[i] == '\x0F')
-		{
-			if (str.length() <= i + 3)
-				break;
-			i += 3;
-		}
-		else if (str[i] == '\x0E')
-			continue;
-		else if (str[i] == '\x01')
-			continue;
-		else if (str[i] == '\b')
-		{
-			if (str.length() <= i + 1)
-				break;
-			i++;
-		}
-		else
-			curX += CharWidth(str[i]);
-	}
-	size.X = std::max(curX, size.X);
-	return size;
+	return TextLayout::Get(str).size;
 }
 
 template<typename Derived>
@@ -0,0 +1,145 @@
+#include "TextLayout.h"
+#include <list>
+#include <unordered_map>
+
+constexpr size_t layoutCacheSize = 256;
+// Longer strings are mostly console output and the like, which rarely repeat
+// and would just push HUD lines out of the cache.
+constexpr size_t layoutCacheMaxLength = 1024;
+
+namespace
+{
+	struct StringHash
+	{
+		size_t operator ()(String const &str) const
+		{
+			return std::hash<std::basic_string<char32_t>>()(str);
+		}
+	};
+
+	struct LayoutCache
+	{
+		using Entry = std::pair<String, TextLayout>;
+		std::list<Entry> entries; // most recently used first
+		std::unordered_map<String, std::list<Entry>::iterator, StringHash> index;
+		uint32_t generation = 0;
+		TextLayout scratch;
+	};
+}
+
+static void Layout(TextLayout &layout, String const &str)
+{
+	layout.items.clear();
+	bool underline = false;
+	bool invert = false;
+	TextLayout::Item current;
+	auto invertColour = [&current]() {
+		if (current.fixedColour)
+			current.colour = current.colour.Inverse();
+		else
+			current.inverse = !current.inverse;
+	};
+	auto fixColour = [&current](RGB<uint8_t> colour) {
+		current.fixedColour = true;
+		current.colour = colour;
+	};
+	Vec2<int> pos = Vec2(0, 0);
+	int width = 0;
+	for (size_t i = 0; i < str.length(); i++)
+	{
+		if (str[i] == '\n')
+		{
+			width = std::max(width, pos.X);
+			pos.X = 0;
+			pos.Y += FONT_H;
+		}
+		else if (str[i] == '\x0F')
+		{
+			if (str.length() <= i + 3)
+				break;
+			fixColour(RGB<uint8_t>(uint8_t(str[i + 1]), uint8_t(str[i + 2]), uint8_t(str[i + 3])));
+			i += 3;
+		}
+		else if (str[i] == '\x0E')
+		{
+			current.fixedColour = false;
+			current.inverse = false;
+		}
+		else if (str[i] == '\x01')
+		{
+			invert = !invert;
+			invertColour();
+		}
+		else if (str[i] == '\b')
+		{
+			if (str.length() <= i + 1)
+				break;
+			bool colourCode = true;
+			switch (str[i + 1])
+			{
+			case 'U': underline = !underline; colourCode = false; break;
+			case 'w': fixColour(0xFFFFFF_rgb); break;
+			case 'g': fixColour(0xC0C0C0_rgb); break;
+			case 'o': fixColour(0xFFD820_rgb); break;
+			case 'r': fixColour(0xFF0000_rgb); break;
+			case 'l': fixColour(0xFF4B4B_rgb); break;
+			case 'b': fixColour(0x0000FF_rgb); break;
+			case 't': fixColour(0x20AAFF_rgb); break;
+			case 'u': fixColour(0x9353D3_rgb); break;
+			}
+			if (colourCode && invert)
+				invertColour();
+			i++;
+		}
+		else
+		{
+			auto &glyph = FontReader::LookupGlyph(str[i]);
+			current.pos = pos;
+			current.glyph = &glyph;
+			current.underline = underline;
+			layout.items.push_back(current);
+			pos.X += glyph.Width;
+		}
+	}
+	layout.end = pos;
+	layout.size = Vec2(std::max(width, pos.X), pos.Y + FONT_H - 2);
+}
+
+TextLayout const &TextLayout::Get(String const &str)
+{
+	thread_local LayoutCache cache;
+	auto generation = FontReader::GlyphGeneration();
+	if (cache.generation != generation)
+	{
+		cache.index.clear();
+		cache.entries.clear();
+		cache.generation = generation;
+	}
+	if (str.length() > layoutCacheMaxLength)
+	{
+		Layout(cache.scratch, str);
+		return cache.scratch;
+	}
+	auto it = cache.index.find(str);
+	if (it != cache.index.end())
+	{
+		cache.entries.splice(cache.entries.begin(), cache.entries, it->second);
+		return it->second->second;
+	}
+	if (cache.entries.size() >= layoutCacheSize)
+	{
+		// Reuse the least recently used entry's storage
+		auto last = std::prev(cache.entries.end());
+		cache.index.erase(last->first);
+		cache.entries.splice(cache.entries.begin(), cache.entries, last);
+		cache.entries.front().first = str;
+	}
+	else
+	{
+		cache.entries.emplace_front(str, TextLayout());
+	}
+	auto &entry = cache.entries.front();
+	Layout(entry.second, str);
+	cache.index.emplace(str, cache.entries.begin());
+	return entry.second;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <vector>
+#include "common/String.h"
+#include "common/Vec2.h"
+#include "FontReader.h"
+#include "Pixel.h"
+
+// The result of interpreting the formatting codes in a string once: which
+// glyph goes where and how its colour derives from the colour the text is
+// drawn with. None of this depends on that colour, so layouts are cached per
+// string and shared by BlendText and TextSize.
+struct TextLayout
+{
+	struct Item
+	{
+		Vec2<int> pos = Vec2(0, 0);
+		FontGlyph const *glyph = nullptr;
+		RGB<uint8_t> colour = 0x000000_rgb; // only used if fixedColour is set
+		bool fixedColour = false;
+		bool inverse = false;
+		bool underline = false;
+
+		RGB<uint8_t> Colour(RGB<uint8_t> base) const
+		{
+			if (fixedColour)
+				return colour;
+			return inverse ? base.Inverse() : base;
+		}
+	};
+
+	std::vector<Item> items;
+	// Offset between the first character and the would-be-next character
+	Vec2<int> end = Vec2(0, 0);
+	// Same as RasterDrawMethods::TextSize
+	Vec2<int> size = Vec2(0, 0);
+
+	// The reference is valid until the next call to Get on the same thread.
+	static TextLayout const &Get(String const &str);
+};
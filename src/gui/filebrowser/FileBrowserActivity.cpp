@@ -1,4 +1,5 @@
 #include "FileBrowserActivity.h"
+#include "client/Client.h"
 
 #include "client/GameSave.h"
 #include "client/SaveFile.h"
@@ -193,6 +194,8 @@ void FileBrowserActivity::loadDirectory(ByteString directory, ByteString search)
 	}
 
 	cleanup();
+	// Saves still being written would otherwise be missing or cut short
+	Client::Ref().FlushSaveFiles();
 
 	infoText->Visible = false;
 	itemList->Visible = false;
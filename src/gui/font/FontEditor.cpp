@@ -262,6 +262,7 @@ FontEditor::FontEditor(ByteString _dataFile):
 	font_data = fontData.data();
 	font_ptrs = fontPtrs.data();
 	font_ranges = (unsigned int (*)[2])fontRanges.data();
+	FontReader::InvalidateGlyphs();
 	
 	int baseline = 8 + FONT_H * FONT_SCALE + 4 + FONT_H + 4 + 1;
 	int currentX = 1;
@@ -620,6 +621,7 @@ void FontEditor::Render()
 	font_data = fontData.data();
 	font_ptrs = fontPtrs.data();
 	font_ranges = (unsigned int (*)[2])fontRanges.data();
+	FontReader::InvalidateGlyphs();
 }
 
 void FontEditor::Save()
@@ -24,6 +24,7 @@
 #include "debug/DebugParts.h"
 #include "debug/ElementPopulation.h"
 #include "debug/ParticleDebug.h"
+#include "debug/RequestDebug.h"
 #include "debug/SurfaceNormals.h"
 #include "graphics/Renderer.h"
 #include "simulation/Air.h"
@@ -100,6 +101,12 @@ GameController::GameController():
 	debugInfo.push_back(std::make_unique<DebugLines            >(DEBUG_LINES     , gameView, this));
 	debugInfo.push_back(std::make_unique<ParticleDebug         >(DEBUG_PARTICLE  , gameModel->GetSimulation(), gameModel, this));
 	debugInfo.push_back(std::make_unique<SurfaceNormals        >(DEBUG_SURFNORM  , gameModel->GetSimulation(), gameView, this));
+	debugInfo.push_back(std::make_unique<RequestDebug          >(DEBUG_HTTP));
+}
+
+void GameController::AddDebugInfo(std::unique_ptr<DebugInfo> info)
+{
+	debugInfo.push_back(std::move(info));
 }
 
 GameController::~GameController()
@@ -1371,28 +1378,15 @@ void GameController::OpenLocalSaveWindow(bool asCurrent)
 		if (!asCurrent || !gameModel->GetSaveFile())
 		{
 			tempSave->SetGameSave(std::move(gameSave));
+			// Called once the file is written, by which time the simulation may
+			// have moved on; it is not reset to what was saved
 			new LocalSaveActivity(std::move(tempSave), [this](auto file) {
-				gameModel->SetSaveFile(std::move(file), gameView->ShiftBehaviour());
+				gameModel->AdoptSaveFile(std::move(file));
 			});
 		}
 		else if (gameModel->GetSaveFile())
 		{
 			std::string filename = gameModel->GetSaveFile()->GetName();
-			if (GetAutoreloadEnabled() && Platform::FileExists(filename))
-			{
-				try
-				{
-					std::vector<char> data;
-					if (Platform::ReadFile(data, filename))
-					{
-						Platform::WriteFile(data, filename + std::string(".backup"));
-					}
-				}
-				catch(std::exception & e)
-				{
-					new ErrorMessage("Error", "Unable to make backup.");
-				}
-			}
 
 			Json::Value localSaveInfo;
 			localSaveInfo["type"] = "localsave";
@@ -1403,16 +1397,21 @@ void GameController::OpenLocalSaveWindow(bool asCurrent)
 			gameSave->authors = localSaveInfo;
 
 			Platform::MakeDirectory(LOCAL_SAVE_DIR);
-			std::vector<char> saveData;
-			std::tie(std::ignore, saveData) = gameSave->Serialise();
+			SaveWriter::Job job;
+			job.path = filename;
+			job.save = std::make_unique<GameSave>(*gameSave);
+			job.backup = GetAutoreloadEnabled();
+			job.onDone = [this](const SaveWriter::Result &result) {
+				if (result.backupFailed)
+					new ErrorMessage("Error", "Unable to make backup.");
+				if (result.error.size())
+					new ErrorMessage("Error", result.error);
+				else
+					gameModel->SetInfoTip("Saved Successfully");
+			};
+			Client::Ref().WriteSaveFile(std::move(job));
 			tempSave->SetGameSave(std::move(gameSave));
 			gameModel->SetSaveFile(std::move(tempSave), gameView->ShiftBehaviour());
-			if (saveData.size() == 0)
-				new ErrorMessage("Error", "Unable to serialize game data.");
-			else if (!Platform::WriteFile(saveData, filename))
-				new ErrorMessage("Error", "Unable to write save file.");
-			else
-				gameModel->SetInfoTip("Saved Successfully");
 		}
 	}
 }
@@ -1785,6 +1784,16 @@ void GameController::SetRecordInterval(int val)
 	gameView->SetRecordInterval(val);
 }
 
+std::optional<FrameWriter::Codec> GameController::GetRecordingCodec()
+{
+	return gameView->GetRecordingCodec();
+}
+
+void GameController::SetRecordingCodec(std::optional<FrameWriter::Codec> codec)
+{
+	gameView->SetRecordingCodec(codec);
+}
+
 void GameController::NotifyAuthUserChanged(Client * sender)
 {
 	User newUser = sender->GetAuthUser();
@@ -6,6 +6,7 @@
 #include "gui/interface/Colour.h"
 #include "gui/game/Tool.h"
 #include "gui/SavePreviewType.h"
+#include "graphics/FrameWriter.h"
 #include "simulation/Sign.h"
 #include "simulation/Particle.h"
 #include "simulation/Sample.h"
@@ -19,6 +20,8 @@ constexpr auto DEBUG_ELEMENTPOP = 0x0002;
 constexpr auto DEBUG_LINES      = 0x0004;
 constexpr auto DEBUG_PARTICLE   = 0x0008;
 constexpr auto DEBUG_SURFNORM   = 0x0010;
+constexpr auto DEBUG_LUAPROFILE = 0x0020;
+constexpr auto DEBUG_HTTP       = 0x0040;
 
 class DebugInfo;
 class SaveFile;
@@ -135,6 +138,7 @@ public:
 	bool GetParticleDebugEnabled() { return debugFlags & 0x8; }
 	void SetDebugFlags(unsigned int flags) { debugFlags = flags; }
 	unsigned int GetDebugFlags() const { return debugFlags; }
+	void AddDebugInfo(std::unique_ptr<DebugInfo> info);
 	bool GetAutoreloadEnabled() { return autoreloadEnabled; }
 	void SetAutoreloadEnabled(bool e) { autoreloadEnabled = e; }
 	void SetActiveMenu(int menuID);
@@ -206,6 +210,8 @@ public:
 	int Record(bool record, bool subframe = false);
 	int GetRecordInterval();
 	void SetRecordInterval(int val);
+	std::optional<FrameWriter::Codec> GetRecordingCodec();
+	void SetRecordingCodec(std::optional<FrameWriter::Codec> codec);
 
 	void ResetAir();
 	void ResetSpark();
@@ -1092,6 +1092,14 @@ void GameModel::SetSaveFile(std::unique_ptr<SaveFile> newSave, bool invertInclud
 	UpdateQuickOptions();
 }
 
+void GameModel::AdoptSaveFile(std::unique_ptr<SaveFile> newSave)
+{
+	currentFile = std::move(newSave);
+	currentSave.reset();
+	SetWasModified(false);
+	notifySaveChanged();
+}
+
 bool GameModel::AreParticlesInSubframeOrder()
 {
 	return sim->AreParticlesInSubframeOrder();
@@ -213,6 +213,8 @@ public:
 	std::unique_ptr<SaveFile> TakeSaveFile();
 	void SetSave(std::unique_ptr<SaveInfo> newSave, bool invertIncludePressure);
 	void SetSaveFile(std::unique_ptr<SaveFile> newSave, bool invertIncludePressure);
+	// Makes a file just saved from the simulation the current one, without loading it back in.
+	void AdoptSaveFile(std::unique_ptr<SaveFile> newSave);
 	void AddObserver(GameView * observer);
 	bool AreParticlesInSubframeOrder();
 
@@ -1052,6 +1052,8 @@ int GameView::Record(bool record, bool subframe)
 		recordingFolder = 0;
 		recordingSubframe = false;
 		recordIntervalIndex = 0;
+		// Waits for the frames still queued
+		recordingWriter.reset();
 	}
 	else if (recording && subframe && !recordingSubframe)
 	{
@@ -1067,6 +1069,10 @@ int GameView::Record(bool record, bool subframe)
 		recording = true;
 		recordingIndex = 0;
 		recordIntervalIndex = 0;
+		auto codec = recordingCodec.value_or(FrameWriter::codecPPM);
+		// Consecutive subframe frames differ by a particle or so, so deltas between them are tiny
+		auto keyframeInterval = subframe ? 2000 : 300;
+		recordingWriter = std::make_unique<FrameWriter>(ByteString::Build("recordings", PATH_SEP_CHAR, recordingFolder, PATH_SEP_CHAR, "frame"), codec, 16, keyframeInterval);
 
 		if (subframe)
 		{
@@ -2507,11 +2513,9 @@ void GameView::OnDraw()
 
 		if (recording && recordIntervalIndex == 0)
 		{
-			std::vector<char> data = ren->DumpFrame().ToPPM();
-
-			ByteString filename = ByteString::Build("recordings", PATH_SEP_CHAR, recordingFolder, PATH_SEP_CHAR, "frame_", Format::Width(recordingIndex++, 6), ".ppm");
-
-			Platform::WriteFile(data, filename);
+			// Encoded and written on the writer's thread
+			recordingWriter->Push(ren->DumpFrame());
+			recordingIndex++;
 		}
 
 		if (recording)
@@ -2551,6 +2555,18 @@ void GameView::OnDraw()
 	if (recording)
 	{
 		String sampleInfo = String::Build("#", screenshotIndex, " ", String(0xE00E), " REC");
+		auto stats = recordingWriter->GetStats();
+		if (recordingWriter->GetError())
+			sampleInfo += String::Build(" [write error]");
+		else if (stats.queued || stats.stalls)
+		{
+			// Back-pressure: frames waiting to be written, and how often the
+			// simulation had to wait for the writer
+			sampleInfo += String::Build(" [", stats.queued, "/", stats.capacity, " queued");
+			if (stats.stalls)
+				sampleInfo += String::Build(", ", stats.stalls, " waits, ", stats.stallMs, " ms");
+			sampleInfo += String::Build("]");
+		}
 
 		int textWidth = Graphics::TextSize(sampleInfo).X - 1;
 		g->BlendFilledRect(RectSized(Vec2{ XRES-20-textWidth, 12 }, Vec2{ textWidth+8, 15 }), 0x000000_rgb .WithAlpha(127));
@@ -2,6 +2,7 @@
 #include "common/String.h"
 #include "gui/interface/Window.h"
 #include "graphics/FindingElement.h"
+#include "graphics/FrameWriter.h"
 #include <ctime>
 #include <deque>
 #include <memory>
@@ -84,6 +85,9 @@ private:
 	bool recordingSubframe;
 	int recordInterval;
 	int recordIntervalIndex;
+	// Unset: PPM
+	std::optional<FrameWriter::Codec> recordingCodec;
+	std::unique_ptr<FrameWriter> recordingWriter;
 
 	ui::Point currentPoint, lastPoint;
 	GameController * c;
@@ -180,6 +184,8 @@ public:
 	bool GetRecordingSubframe(){ return recordingSubframe; }
 	int GetRecordInterval() { return recordInterval; }
 	void SetRecordInterval(int val) { recordInterval = val; }
+	std::optional<FrameWriter::Codec> GetRecordingCodec() { return recordingCodec; }
+	void SetRecordingCodec(std::optional<FrameWriter::Codec> val) { recordingCodec = val; }
 
 	//all of these are only here for one debug lines
 	bool GetMouseDown() { return isMouseDown; }
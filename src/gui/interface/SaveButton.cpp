@@ -4,6 +4,7 @@
 #include "Format.h"
 
 #include "client/Client.h"
+#include "client/GameSave.h"
 #include "client/ThumbnailRendererTask.h"
 #include "client/SaveFile.h"
 #include "client/SaveInfo.h"
@@ -138,10 +139,23 @@ void SaveButton::Tick(float dt)
 					triedThumbnail = true;
 				}
 			}
-			else if (file && file->GetGameSave())
+			else if (file)
 			{
-				thumbnailRenderer = new ThumbnailRendererTask(*file->GetGameSave(), thumbBoxSize, true, false);
-				thumbnailRenderer->Start();
+				if (file->GetGameSave())
+				{
+					thumbnailRenderer = new ThumbnailRendererTask(*file->GetGameSave(), thumbBoxSize, true, false);
+				}
+				else if (!file->GetError().size())
+				{
+					// Loaded in the background and handed to file once done,
+					// unless the thumbnail cache saves the trouble
+					thumbnailRenderer = new ThumbnailRendererTask(file->GetName(), thumbBoxSize, true, false);
+				}
+				if (thumbnailRenderer)
+				{
+					thumbnailRenderer->UseCache(file->GetName());
+					thumbnailRenderer->Start();
+				}
 				triedThumbnail = true;
 			}
 		}
@@ -161,9 +175,22 @@ void SaveButton::Tick(float dt)
 
 		if (thumbnailRenderer)
 		{
+			// Thumbnails of buttons scrolled out of view can wait
+			thumbnailRenderer->SetPriority(wantsDraw ? Task::priorityVisible : Task::priorityOffscreen);
 			thumbnailRenderer->Poll();
 			if (thumbnailRenderer->GetDone())
 			{
+				if (file && thumbnailRenderer->GetError().size())
+				{
+					file->SetLoadingError(thumbnailRenderer->GetError());
+				}
+				else if (file && !file->GetGameSave())
+				{
+					if (auto loadedSave = thumbnailRenderer->TakeSave())
+					{
+						file->SetGameSave(std::move(loadedSave));
+					}
+				}
 				thumbnail = thumbnailRenderer->Finish();
 				thumbnailRenderer = nullptr;
 			}
@@ -201,7 +228,7 @@ void SaveButton::Draw(const Point& screenPos)
 		auto space = Size - Vec2{ 0, 21 };
 		g->BlendImage(tex->Data(), 255, RectSized(screenPos + ((save && save->id) ? ((space - thumbBoxSize) / 2 - Vec2{ 3, 0 }) : (space - thumbSize) / 2), tex->Size()));
 	}
-	else if (file && !file->LazyGetGameSave())
+	else if (file && file->GetError().size())
 		g->BlendText(screenPos + Vec2{ (Size.X-(Graphics::TextSize("Error loading save").X - 1))/2, (Size.Y-28)/2 }, "Error loading save", 0xB4B4B4_rgb .WithAlpha(255));
 	if(save)
 	{
@@ -58,6 +58,8 @@ std::unique_ptr<SaveFile> LocalBrowserModel::TakeSave()
 void LocalBrowserModel::OpenSave(int index)
 {
 	stamp = std::move(savesList[index]);
+	// Stamps are loaded lazily; this also records any error in the SaveFile
+	stamp->LazyGetGameSave();
 	savesList.clear();
 	notifyPageChanged();
 	notifySavesListChanged();
@@ -83,7 +85,8 @@ void LocalBrowserModel::UpdateSavesList(int pageNumber)
 	auto size = int(stampIDs.size());
 	for (int i = currentPage * pageSize; i < size && i < (currentPage + 1) * pageSize; i++)
 	{
-		auto tempSave = Client::Ref().GetStamp(stampIDs[i]);
+		// Saves are only loaded if their thumbnails are not cached
+		auto tempSave = Client::Ref().GetStamp(stampIDs[i], true);
 		if (tempSave)
 		{
 			savesList.push_back(std::move(tempSave));
@@ -97,6 +97,11 @@ void OptionsController::SetShowAvatars(bool showAvatars)
 	model->SetShowAvatars(showAvatars);
 }
 
+void OptionsController::SetPrefetch(bool prefetch)
+{
+	model->SetPrefetch(prefetch);
+}
+
 void OptionsController::SetScale(int scale)
 {
 	model->SetScale(scale);
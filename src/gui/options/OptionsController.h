@@ -35,6 +35,7 @@ public:
 	void SetFastQuit(bool fastquit);
 	void SetDecoSpace(int decoSpace);
 	void SetShowAvatars(bool showAvatars);
+	void SetPrefetch(bool prefetch);
 	void SetMouseClickrequired(bool mouseClickRequired);
 	void SetIncludePressure(bool includePressure);
 	void SetPerfectCircle(bool perfectCircle);
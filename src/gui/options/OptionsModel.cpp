@@ -270,6 +270,17 @@ void OptionsModel::SetShowAvatars(bool state)
 	notifySettingsChanged();
 }
 
+bool OptionsModel::GetPrefetch()
+{
+	return GlobalPrefs::Ref().Get("Prefetch", false);
+}
+
+void OptionsModel::SetPrefetch(bool state)
+{
+	GlobalPrefs::Ref().Set("Prefetch", state);
+	notifySettingsChanged();
+}
+
 bool OptionsModel::GetMouseClickRequired()
 {
 	return gModel->GetMouseClickRequired();
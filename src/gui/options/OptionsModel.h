@@ -23,6 +23,8 @@ public:
 	void SetWaterEqualisation(bool state);
 	bool GetShowAvatars();
 	void SetShowAvatars(bool state);
+	bool GetPrefetch();
+	void SetPrefetch(bool state);
 	int GetAirMode();
 	void SetAirMode(int airMode);
 	float GetAmbientAirTemperature();
@@ -290,6 +290,9 @@ OptionsView::OptionsView() : ui::Window(ui::Point(-1, -1), ui::Point(320, 340))
 	showAvatars = addCheckbox(0, "Show avatars", "Disable if you have a slow connection", [this] {
 		c->SetShowAvatars(showAvatars->GetChecked());
 	});
+	prefetch = addCheckbox(0, "Load ahead when browsing online", "The next page of saves or comments", [this] {
+		c->SetPrefetch(prefetch->GetChecked());
+	});
 	momentumScroll = addCheckbox(0, "Momentum (old) scrolling", "Accelerating instead of step scroll", [this] {
 		c->SetMomentumScroll(momentumScroll->GetChecked());
 	});
@@ -486,6 +489,7 @@ void OptionsView::NotifySettingsChanged(OptionsModel * sender)
 		nativeClipoard->SetChecked(sender->GetNativeClipoard());
 	}
 	showAvatars->SetChecked(sender->GetShowAvatars());
+	prefetch->SetChecked(sender->GetPrefetch());
 	mouseClickRequired->SetChecked(sender->GetMouseClickRequired());
 	includePressure->SetChecked(sender->GetIncludePressure());
 	perfectCircle->SetChecked(sender->GetPerfectCircle());
@@ -35,6 +35,7 @@ class OptionsView: public ui::Window
 	ui::Checkbox *fastquit{};
 	ui::DropDown *decoSpace{};
 	ui::Checkbox *showAvatars{};
+	ui::Checkbox *prefetch{};
 	ui::Checkbox *momentumScroll{};
 	ui::Checkbox *mouseClickRequired{};
 	ui::Checkbox *includePressure{};
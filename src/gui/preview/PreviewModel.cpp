@@ -9,6 +9,7 @@
 #include "client/GameSave.h"
 #include "client/SaveInfo.h"
 #include "gui/dialogues/ErrorMessage.h"
+#include "prefs/GlobalPrefs.h"
 #include "PreviewView.h"
 #include "Config.h"
 #include <cmath>
@@ -16,6 +17,13 @@
 
 constexpr auto commentsPerPage = 20;
 
+PreviewModel::PreviewModel()
+{
+	prefetch = GlobalPrefs::Ref().Get("Prefetch", false);
+}
+
+PreviewModel::~PreviewModel() = default;
+
 void PreviewModel::SetFavourite(bool favourite)
 {
 	if (saveInfo)
@@ -46,6 +54,7 @@ void PreviewModel::UpdateSave(int saveID, int saveDate)
 	saveInfo.reset();
 	saveData.reset();
 	saveComments.reset();
+	ResetPrefetch();
 	notifySaveChanged();
 	notifySaveCommentsChanged();
 
@@ -122,8 +131,23 @@ void PreviewModel::UpdateComments(int pageNumber)
 		saveComments.reset();
 
 		commentsPageNumber = pageNumber;
-		if (!GetDoOpen())
+		if (prefetchCommentsPage == commentsPageNumber && prefetchedComments)
+		{
+			saveComments = std::move(prefetchedComments);
+			commentsLoaded = true;
+			ResetPrefetch();
+			BeginPrefetchComments();
+		}
+		else if (prefetchCommentsPage == commentsPageNumber && prefetchCommentsDownload)
 		{
+			commentsDownload = std::move(prefetchCommentsDownload);
+			// Somebody is waiting on it now
+			commentsDownload->SetPriority(http::Request::priorityInteractive);
+			ResetPrefetch();
+		}
+		else if (!GetDoOpen())
+		{
+			ResetPrefetch();
 			commentsDownload = std::make_unique<http::GetCommentsRequest>(saveID, (commentsPageNumber - 1) * commentsPerPage, commentsPerPage);
 			commentsDownload->Start();
 		}
@@ -133,6 +157,25 @@ void PreviewModel::UpdateComments(int pageNumber)
 	}
 }
 
+void PreviewModel::BeginPrefetchComments()
+{
+	if (!prefetch || GetDoOpen() || !commentsLoaded || prefetchCommentsPage || commentsPageNumber >= GetCommentsPageCount())
+	{
+		return;
+	}
+	prefetchCommentsPage = commentsPageNumber + 1;
+	prefetchCommentsDownload = std::make_unique<http::GetCommentsRequest>(saveID, (prefetchCommentsPage - 1) * commentsPerPage, commentsPerPage);
+	prefetchCommentsDownload->SetPriority(http::Request::priorityPrefetch);
+	prefetchCommentsDownload->Start();
+}
+
+void PreviewModel::ResetPrefetch()
+{
+	prefetchCommentsPage = 0;
+	prefetchCommentsDownload.reset();
+	prefetchedComments.reset();
+}
+
 void PreviewModel::CommentAdded()
 {
 	if (saveInfo)
@@ -160,6 +203,8 @@ void PreviewModel::OnSaveReady()
 	//make sure author name comments are red
 	if (commentsLoaded)
 		notifySaveCommentsChanged();
+	// The number of pages is only known now
+	BeginPrefetchComments();
 }
 
 void PreviewModel::Update()
@@ -226,6 +271,20 @@ void PreviewModel::Update()
 		notifySaveCommentsChanged();
 		notifyCommentsPageChanged();
 		commentsDownload.reset();
+		BeginPrefetchComments();
+	}
+	if (prefetchCommentsDownload && prefetchCommentsDownload->CheckDone())
+	{
+		try
+		{
+			prefetchedComments = prefetchCommentsDownload->Finish();
+		}
+		catch (const http::RequestError &)
+		{
+			// Not worth reporting, the page is requested again if it is needed
+			prefetchCommentsPage = 0;
+		}
+		prefetchCommentsDownload.reset();
 	}
 
 	if (favouriteSaveRequest && favouriteSaveRequest->CheckDone())
@@ -43,7 +43,18 @@ class PreviewModel
 
 	std::optional<bool> queuedFavourite;
 
+	// Opt-in: the next page of comments is loaded while the user reads the current one
+	bool prefetch;
+	int prefetchCommentsPage = 0;
+	std::unique_ptr<http::GetCommentsRequest> prefetchCommentsDownload;
+	std::optional<std::vector<Comment>> prefetchedComments;
+	void BeginPrefetchComments();
+	void ResetPrefetch();
+
 public:
+	PreviewModel();
+	~PreviewModel();
+
 	const SaveInfo *GetSaveInfo() const;
 	std::unique_ptr<SaveInfo> TakeSaveInfo();
 	const std::vector<Comment> *GetComments() const
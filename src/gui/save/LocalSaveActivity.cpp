@@ -84,6 +84,7 @@ void LocalSaveActivity::Save()
 		ByteString finalFilename = ByteString::Build(LOCAL_SAVE_DIR, PATH_SEP_CHAR, filenameField->GetText().ToUtf8(), ".cps");
 		save->SetDisplayName(filenameField->GetText());
 		save->SetFileName(finalFilename);
+		Client::Ref().FlushSaveFile(finalFilename);
 		if (Platform::FileExists(finalFilename))
 		{
 			new ConfirmPrompt("Overwrite file", "Are you sure you wish to overwrite\n"+finalFilename.FromUtf8(), { [this, finalFilename] {
@@ -115,20 +116,19 @@ void LocalSaveActivity::saveWrite(ByteString finalFilename)
 		gameSave->authors = localSaveInfo;
 		save->SetGameSave(std::move(gameSave));
 	}
-	std::vector<char> saveData;
-	std::tie(std::ignore, saveData) = save->GetGameSave()->Serialise();
-	if (saveData.size() == 0)
-		new ErrorMessage("Error", "Unable to serialize game data.");
-	else if (!Platform::WriteFile(saveData, finalFilename))
-		new ErrorMessage("Error", "Unable to write save file.");
-	else
-	{
-		if (onSaved)
-		{
-			onSaved(std::move(save));
-		}
-		Exit();
-	}
+	SaveWriter::Job job;
+	job.path = finalFilename;
+	job.save = std::make_unique<GameSave>(*save->GetGameSave());
+	// The game only switches to the new file once it has actually been written
+	auto savedFile = std::make_shared<std::unique_ptr<SaveFile>>(std::move(save));
+	job.onDone = [onSaved = onSaved, savedFile](const SaveWriter::Result &result) {
+		if (result.error.size())
+			new ErrorMessage("Error", result.error);
+		else if (onSaved)
+			onSaved(std::move(*savedFile));
+	};
+	Client::Ref().WriteSaveFile(std::move(job));
+	Exit();
 }
 
 void LocalSaveActivity::OnDraw()
@@ -6,6 +6,8 @@
 #include "client/Client.h"
 #include "client/http/SearchSavesRequest.h"
 #include "client/http/SearchTagsRequest.h"
+#include "client/http/ThumbnailRequest.h"
+#include "prefs/GlobalPrefs.h"
 #include <algorithm>
 #include <thread>
 #include <cmath>
@@ -18,8 +20,14 @@ SearchModel::SearchModel():
 	showFavourite(false),
 	showTags(true)
 {
+	prefetch = GlobalPrefs::Ref().Get("Prefetch", false);
 }
 
+SearchModel::~SearchModel() = default;
+
+// A listing this old is fetched again rather than shown
+constexpr auto prefetchedPageMaxAge = std::chrono::minutes(1);
+
 void SearchModel::SetShowTags(bool show)
 {
 	showTags = show;
@@ -111,21 +119,89 @@ bool SearchModel::UpdateSaveList(int pageNumber, String query)
 			BeginGetTags(0, 24, "");
 		}
 
-		auto category = http::categoryNone;
-		if (showFavourite)
+		auto category = CurrentCategory();
+		PageKey key{ currentPage, lastQuery, currentSort, category };
+		// Navigating cancels thumbnail prefetches; the next page's save list is
+		// kept if it is for the page navigated to
+		prefetcher.Clear();
+		if (prefetchedPage && prefetchedPage->key == key && std::chrono::steady_clock::now() - prefetchedPage->loadedAt < prefetchedPageMaxAge)
+		{
+			resultCount = prefetchedPage->resultCount;
+			saveList = std::move(prefetchedPage->saves);
+			prefetchedPage.reset();
+			saveListLoaded = true;
+			notifyPageChanged();
+			notifySaveListChanged();
+			BeginPrefetch();
+			return true;
+		}
+		prefetchedPage.reset();
+		if (prefetchSaves && prefetchSavesKey == key)
 		{
-			category = http::categoryFavourites;
+			resultCount = 0;
+			searchSaves = std::move(prefetchSaves);
+			// Somebody is waiting on it now
+			searchSaves->SetPriority(http::Request::priorityInteractive);
 		}
-		if (showOwn && Client::Ref().GetAuthUser().UserID)
+		else
 		{
-			category = http::categoryMyOwn;
+			prefetchSaves.reset();
+			BeginSearchSaves((currentPage-1)*20, 20, lastQuery, currentSort, category);
 		}
-		BeginSearchSaves((currentPage-1)*20, 20, lastQuery, currentSort, category);
+		prefetchSavesKey.reset();
 		return true;
 	}
 	return false;
 }
 
+http::Category SearchModel::CurrentCategory()
+{
+	auto category = http::categoryNone;
+	if (showFavourite)
+	{
+		category = http::categoryFavourites;
+	}
+	if (showOwn && Client::Ref().GetAuthUser().UserID)
+	{
+		category = http::categoryMyOwn;
+	}
+	return category;
+}
+
+void SearchModel::BeginPrefetch()
+{
+	if (!prefetch || currentPage >= GetPageCount() || prefetchSaves || prefetchedPage)
+	{
+		return;
+	}
+	prefetchSavesKey = PageKey{ currentPage + 1, lastQuery, currentSort, CurrentCategory() };
+	prefetchSaves = std::make_unique<http::SearchSavesRequest>(currentPage*20, 20, lastQuery.ToUtf8(), currentSort, prefetchSavesKey->category);
+	prefetchSaves->SetPriority(http::Request::priorityPrefetch);
+	prefetchSaves->Start();
+}
+
+void SearchModel::EndPrefetch()
+{
+	PrefetchedPage page;
+	page.key = *prefetchSavesKey;
+	page.loadedAt = std::chrono::steady_clock::now();
+	try
+	{
+		std::tie(page.resultCount, page.saves) = prefetchSaves->Finish();
+		for (auto &save : page.saves)
+		{
+			// Only the response is wanted, so the size of the thumbnail does not matter
+			prefetcher.Add(std::make_unique<http::ThumbnailRequest>(save->GetID(), save->GetVersion(), Vec2(0, 0)));
+		}
+		prefetchedPage = std::move(page);
+	}
+	catch (const http::RequestError &)
+	{
+	}
+	prefetchSaves.reset();
+	prefetchSavesKey.reset();
+}
+
 void SearchModel::SetLoadedSave(std::unique_ptr<SaveInfo> save)
 {
 	loadedSave = std::move(save);
@@ -164,7 +240,13 @@ void SearchModel::Update()
 		saveList = EndSearchSaves();
 		notifyPageChanged();
 		notifySaveListChanged();
+		BeginPrefetch();
+	}
+	if (prefetchSaves && prefetchSaves->CheckDone())
+	{
+		EndPrefetch();
 	}
+	prefetcher.Update();
 	if (getTags && getTags->CheckDone())
 	{
 		lastError = "";
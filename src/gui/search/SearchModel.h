@@ -1,10 +1,13 @@
 #pragma once
 #include "common/String.h"
 #include "client/Search.h"
+#include "client/http/Prefetcher.h"
 #include "Config.h"
 #include <vector>
 #include <atomic>
+#include <chrono>
 #include <memory>
+#include <optional>
 
 namespace http
 {
@@ -48,8 +51,39 @@ private:
 
 	//Variables and methods for background save request
 	bool saveListLoaded = false;
+
+	// Opt-in: the next page and its thumbnails are loaded while the user
+	// looks at the current one
+	struct PageKey
+	{
+		int page;
+		String query;
+		http::Sort sort;
+		http::Category category;
+
+		bool operator ==(const PageKey &other) const
+		{
+			return page == other.page && query == other.query && sort == other.sort && category == other.category;
+		}
+	};
+	struct PrefetchedPage
+	{
+		PageKey key;
+		std::chrono::steady_clock::time_point loadedAt;
+		int resultCount = 0;
+		std::vector<std::unique_ptr<SaveInfo>> saves;
+	};
+	bool prefetch;
+	std::optional<PageKey> prefetchSavesKey;
+	std::unique_ptr<http::SearchSavesRequest> prefetchSaves;
+	std::optional<PrefetchedPage> prefetchedPage;
+	http::Prefetcher prefetcher;
+	http::Category CurrentCategory();
+	void BeginPrefetch();
+	void EndPrefetch();
 public:
     SearchModel();
+    ~SearchModel();
 
     void SetShowTags(bool show);
     bool GetShowTags();
@@ -72,7 +72,7 @@ void LuaButton::triggerAction()
 	{
 		lua_rawgeti(L, LUA_REGISTRYINDEX, actionFunction);
 		lua_rawgeti(L, LUA_REGISTRYINDEX, owner_ref);
-		if (tpt_lua_pcall(L, 1, 0, 0, eventTraitNone))
+		if (tpt_lua_pcall(L, 1, 0, 0, eventTraitNone, "button.action"))
 		{
 			ci->Log(CommandInterface::LogError, tpt_lua_toString(L, -1));
 		}
@@ -0,0 +1,78 @@
+#include "LuaBytecodeCache.h"
+#include "common/CacheFile.h"
+#include "common/platform/Platform.h"
+#include "Config.h"
+#include <chrono>
+#include <vector>
+
+constexpr char cacheMagic[] = "TPTLUAC1\n";
+
+static int dumpWriter(lua_State *L, const void *p, size_t size, void *ud)
+{
+	auto *data = reinterpret_cast<std::vector<char> *>(ud);
+	data->insert(data->end(), reinterpret_cast<const char *>(p), reinterpret_cast<const char *>(p) + size);
+	return 0;
+}
+
+int LuaBytecodeCache::LoadFile(lua_State *L, ByteString path)
+{
+	auto info = Platform::GetFileInfo(path);
+	if (!enabled || !info)
+	{
+		return luaL_loadfile(L, path.c_str());
+	}
+	return Load(L, "file " + path, ByteString::Build(info->size, " ", info->modified), "@" + path, nullptr, 0, true);
+}
+
+int LuaBytecodeCache::LoadBuffer(lua_State *L, const char *data, size_t size, ByteString chunkName)
+{
+	if (!enabled)
+	{
+		return luaL_loadbuffer(L, data, size, chunkName.c_str());
+	}
+	return Load(L, "buffer " + chunkName, ByteString::Build(size, " ", CacheFile::HashString(data, size)), chunkName, data, size, false);
+}
+
+int LuaBytecodeCache::Load(lua_State *L, const ByteString &name, const ByteString &state, const ByteString &chunkName, const char *source, size_t sourceSize, bool fromFile)
+{
+	auto start = std::chrono::steady_clock::now();
+	auto addTime = [this, start]() {
+		stats.loadUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	};
+	// The entry is named after the chunk alone, so that a chunk that changes
+	// replaces its own entry instead of leaving it behind. Bytecode is also
+	// specific to the Lua implementation and to the size of its types.
+	auto header = ByteString::Build(cacheMagic, LUA_RELEASE, " ", sizeof(void *) * 8, "-bit\n", name, "\n", state, "\n");
+	auto cachePath = ByteString::Build(LUA_CACHE_DIR, PATH_SEP_CHAR, CacheFile::EntryName(name, ".luac"));
+
+	if (Platform::FileExists(cachePath))
+	{
+		// The header does not match if the chunk has changed
+		auto cached = CacheFile::Read(cachePath, header);
+		if (cached && cached->size())
+		{
+			if (!luaL_loadbuffer(L, cached->data(), cached->size(), chunkName.c_str()))
+			{
+				stats.hits++;
+				stats.hitBytes += cached->size();
+				addTime();
+				return 0;
+			}
+			lua_pop(L, 1);
+		}
+		stats.rejected++;
+	}
+
+	stats.misses++;
+	int ret = fromFile ? luaL_loadfile(L, chunkName.substr(1).c_str()) : luaL_loadbuffer(L, source, sourceSize, chunkName.c_str());
+	if (!ret)
+	{
+		std::vector<char> data;
+		if (!lua_dump(L, dumpWriter, &data))
+		{
+			CacheFile::Write(LUA_CACHE_DIR, cachePath, header, data.data(), data.size());
+		}
+	}
+	addTime();
+	return ret;
+}
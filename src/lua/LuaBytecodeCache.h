@@ -0,0 +1,54 @@
+#pragma once
+#include "LuaCompat.h"
+#include "common/String.h"
+#include <cstdint>
+
+// Keeps compiled chunks in LUA_CACHE_DIR so that scripts that have not
+// changed need not be parsed again. There is one entry per path (or chunk
+// name, for chunks loaded from memory); it is only used if the size and
+// modification time of the file (or the contents of the chunk) and the Lua
+// version still match, and is overwritten when the chunk is compiled again.
+// Anything that does not match or does not load is ignored and the chunk is
+// compiled from source instead.
+class LuaBytecodeCache
+{
+public:
+	struct Stats
+	{
+		int hits = 0;
+		int misses = 0;
+		// Entries that were found but could not be used
+		int rejected = 0;
+		uint64_t hitBytes = 0;
+		// Total time spent loading chunks through the cache, hits or not
+		uint64_t loadUs = 0;
+	};
+
+private:
+	bool enabled = true;
+	Stats stats;
+
+	// name identifies the chunk, state the version of it that is being loaded.
+	int Load(lua_State *L, const ByteString &name, const ByteString &state, const ByteString &chunkName, const char *source, size_t sourceSize, bool fromFile);
+
+public:
+	void SetEnabled(bool newEnabled)
+	{
+		enabled = newEnabled;
+	}
+
+	bool GetEnabled() const
+	{
+		return enabled;
+	}
+
+	const Stats &GetStats() const
+	{
+		return stats;
+	}
+
+	// Same as luaL_loadfile.
+	int LoadFile(lua_State *L, ByteString path);
+	// Same as luaL_loadbuffer.
+	int LoadBuffer(lua_State *L, const char *data, size_t size, ByteString chunkName);
+};
@@ -96,6 +96,63 @@ static void manageElementIdentifier(lua_State *L, int id, bool add)
 	}
 }
 
+// Hands the particles of this element that have yet to be updated to its
+// BatchUpdate function in one call: all of them in BATCH_FRAME mode, those up
+// to the next particle of another element in BATCH_RUN mode.
+static void luaBatchUpdate(Simulation *sim, int i, CustomElement &customElement)
+{
+	auto *lsi = GetLSI();
+	auto *parts = sim->parts;
+	auto t = parts[i].type;
+	auto end = i;
+	std::vector<int> &ids = lsi->batchUpdateIds;
+	ids.clear();
+	if (customElement.batchMode == BATCH_RUN)
+	{
+		auto last = std::min(sim->debug_updateEnd - 1, sim->parts_lastActiveIndex);
+		for (auto j = i; j <= last && (parts[j].type == t || !parts[j].type); j++)
+		{
+			if (parts[j].type)
+			{
+				ids.push_back(j);
+			}
+			end = j;
+		}
+	}
+	else
+	{
+		for (auto j = i; j <= sim->parts_lastActiveIndex; j++)
+		{
+			if (parts[j].type == t)
+			{
+				ids.push_back(j);
+			}
+		}
+		end = sim->parts_lastActiveIndex;
+	}
+	customElement.batchLoop = sim->updateLoopCount;
+	customElement.batchEnd = end;
+
+	lua_rawgeti(lsi->L, LUA_REGISTRYINDEX, customElement.batchUpdate);
+	lua_createtable(lsi->L, int(ids.size()), 0);
+	for (auto k = 0; k < int(ids.size()); k++)
+	{
+		lua_pushinteger(lsi->L, ids[k]);
+		lua_rawseti(lsi->L, -2, k + 1);
+	}
+	if (tpt_lua_pcall(lsi->L, 1, 0, 0, eventTraitSimRng, "batchUpdate", t))
+	{
+		lsi->Log(CommandInterface::LogError, LuaGetError());
+	}
+}
+
+static void clearBatchUpdate(CustomElement &customElement)
+{
+	customElement.batchUpdate.Clear();
+	customElement.batchMode = BATCH_FRAME;
+	customElement.batchEnd = -1;
+}
+
 static int luaUpdateWrapper(UPDATE_FUNC_ARGS)
 {
 	if (!sim->useLuaCallbacks)
@@ -106,6 +163,18 @@ static int luaUpdateWrapper(UPDATE_FUNC_ARGS)
 	auto &builtinElements = GetElements();
 	auto *builtinUpdate = builtinElements[parts[i].type].Update;
 	auto &customElements = lsi->customElements;
+	auto t = parts[i].type;
+	auto &customElement = customElements[t];
+	if (customElement.batchUpdate && !(customElement.batchLoop == sim->updateLoopCount && i <= customElement.batchEnd))
+	{
+		luaBatchUpdate(sim, i, customElement);
+		if (parts[i].type != t)
+		{
+			return 1;
+		}
+		x = (int)(parts[i].x+0.5f);
+		y = (int)(parts[i].y+0.5f);
+	}
 	if (builtinUpdate && customElements[parts[i].type].updateMode == UPDATE_AFTER)
 	{
 		if (builtinUpdate(UPDATE_FUNC_SUBCALL_ARGS))
@@ -122,7 +191,7 @@ static int luaUpdateWrapper(UPDATE_FUNC_ARGS)
 		lua_pushinteger(lsi->L, y);
 		lua_pushinteger(lsi->L, surround_space);
 		lua_pushinteger(lsi->L, nt);
-		callret = tpt_lua_pcall(lsi->L, 5, 1, 0, eventTraitSimRng);
+		callret = tpt_lua_pcall(lsi->L, 5, 1, 0, eventTraitSimRng, "update", t);
 		if (callret)
 			lsi->Log(CommandInterface::LogError, LuaGetError());
 		if(lua_isboolean(lsi->L, -1)){
@@ -170,7 +239,7 @@ static int luaGraphicsWrapper(GRAPHICS_FUNC_ARGS)
 		lua_pushinteger(lsi->L, *colr);
 		lua_pushinteger(lsi->L, *colg);
 		lua_pushinteger(lsi->L, *colb);
-		callret = tpt_lua_pcall(lsi->L, 4, 10, 0, eventTraitSimGraphics);
+		callret = tpt_lua_pcall(lsi->L, 4, 10, 0, eventTraitSimGraphics, "graphics", cpart->type);
 		if (callret)
 		{
 			lsi->Log(CommandInterface::LogError, LuaGetError());
@@ -225,7 +294,7 @@ static void luaCreateWrapper(ELEMENT_CREATE_FUNC_ARGS)
 		lua_pushinteger(lsi->L, y);
 		lua_pushinteger(lsi->L, t);
 		lua_pushinteger(lsi->L, v);
-		if (tpt_lua_pcall(lsi->L, 5, 0, 0, eventTraitSimRng))
+		if (tpt_lua_pcall(lsi->L, 5, 0, 0, eventTraitSimRng, "create", sim->parts[i].type))
 		{
 			lsi->Log(CommandInterface::LogError, "In create func: " + LuaGetError());
 			lua_pop(lsi->L, 1);
@@ -252,7 +321,7 @@ static bool luaCreateAllowedWrapper(ELEMENT_CREATE_ALLOWED_FUNC_ARGS)
 		lua_pushinteger(lsi->L, x);
 		lua_pushinteger(lsi->L, y);
 		lua_pushinteger(lsi->L, t);
-		if (tpt_lua_pcall(lsi->L, 4, 1, 0, eventTraitSimRng))
+		if (tpt_lua_pcall(lsi->L, 4, 1, 0, eventTraitSimRng, "createAllowed", t))
 		{
 			lsi->Log(CommandInterface::LogError, "In create allowed: " + LuaGetError());
 			lua_pop(lsi->L, 1);
@@ -283,7 +352,7 @@ static void luaChangeTypeWrapper(ELEMENT_CHANGETYPE_FUNC_ARGS)
 		lua_pushinteger(lsi->L, y);
 		lua_pushinteger(lsi->L, from);
 		lua_pushinteger(lsi->L, to);
-		if (tpt_lua_pcall(lsi->L, 5, 0, 0, eventTraitSimRng))
+		if (tpt_lua_pcall(lsi->L, 5, 0, 0, eventTraitSimRng, "changeType", sim->parts[i].type))
 		{
 			lsi->Log(CommandInterface::LogError, "In change type: " + LuaGetError());
 			lua_pop(lsi->L, 1);
@@ -306,7 +375,7 @@ static bool luaCtypeDrawWrapper(CTYPEDRAW_FUNC_ARGS)
 		lua_pushinteger(lsi->L, i);
 		lua_pushinteger(lsi->L, t);
 		lua_pushinteger(lsi->L, v);
-		if (tpt_lua_pcall(lsi->L, 3, 1, 0, eventTraitSimRng))
+		if (tpt_lua_pcall(lsi->L, 3, 1, 0, eventTraitSimRng, "ctypeDraw", sim->parts[i].type))
 		{
 			lsi->Log(CommandInterface::LogError, LuaGetError());
 			lua_pop(lsi->L, 1);
@@ -449,7 +518,10 @@ static int element(lua_State *L)
 			{
 				customElements[id].update.Clear();
 				customElements[id].updateMode = UPDATE_AFTER;
-				elements[id].Update = builtinElements[id].Update;
+				if (!customElements[id].batchUpdate)
+				{
+					elements[id].Update = builtinElements[id].Update;
+				}
 			}
 			lua_pop(L, 1);
 
@@ -621,7 +693,28 @@ static int property(lua_State *L)
 			{
 				customElements[id].update.Clear();
 				customElements[id].updateMode = UPDATE_AFTER;
-				elements[id].Update = builtinElements[id].Update;
+				if (!customElements[id].batchUpdate)
+				{
+					elements[id].Update = builtinElements[id].Update;
+				}
+			}
+		}
+		else if (propertyName == "BatchUpdate")
+		{
+			if (lua_type(L, 3) == LUA_TFUNCTION)
+			{
+				customElements[id].batchMode = luaL_optint(L, 4, 0) == BATCH_RUN ? BATCH_RUN : BATCH_FRAME;
+				customElements[id].batchUpdate.Assign(L, 3);
+				customElements[id].batchEnd = -1;
+				elements[id].Update = luaUpdateWrapper;
+			}
+			else if (lua_type(L, 3) == LUA_TBOOLEAN && !lua_toboolean(L, 3))
+			{
+				clearBatchUpdate(customElements[id]);
+				if (!customElements[id].update)
+				{
+					elements[id].Update = builtinElements[id].Update;
+				}
 			}
 		}
 		else if (propertyName == "Graphics")
@@ -751,6 +844,8 @@ static int ffree(lua_State *L)
 		sd.elements[id].Enabled = false;
 	}
 	auto *lsi = GetLSI();
+	// Otherwise luaUpdateWrapper would still call it if the ID is reused
+	clearBatchUpdate(lsi->customElements[id]);
 	lsi->gameModel->BuildMenus();
 
 	lua_getglobal(L, "elements");
@@ -777,7 +872,7 @@ static int loadDefault(lua_State *L)
 	auto &builtinElements = GetElements();
 	auto *lsi = GetLSI();
 	{
-		auto loadDefaultOne = [L, &elements, &builtinElements](int id) {
+		auto loadDefaultOne = [L, lsi, &elements, &builtinElements](int id) {
 			lua_getglobal(L, "elements");
 			ByteString identifier = elements[id].Identifier;
 			tpt_lua_pushByteString(L, identifier);
@@ -789,6 +884,7 @@ static int loadDefault(lua_State *L)
 				elements[id] = builtinElements[id];
 			else
 				elements[id] = Element();
+			clearBatchUpdate(lsi->customElements[id]);
 			manageElementIdentifier(L, id, true);
 
 			tpt_lua_pushByteString(L, identifier);
@@ -889,6 +985,8 @@ void LuaElements::Open(lua_State *L)
 	LCONST(UPDATE_REPLACE);
 	LCONST(UPDATE_BEFORE);
 	LCONST(NUM_UPDATEMODES);
+	LCONST(BATCH_FRAME);
+	LCONST(BATCH_RUN);
 #undef LCONST
 	lua_pushvalue(L, -1);
 	lua_setglobal(L, "elements");
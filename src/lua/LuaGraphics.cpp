@@ -1,6 +1,9 @@
 #include "LuaScriptInterface.h"
+#include "graphics/DisplayList.h"
 #include "graphics/Graphics.h"
 #include "graphics/Renderer.h"
+#include <algorithm>
+#include <new>
 
 static int32_t int32Truncate(double n)
 {
@@ -277,6 +280,225 @@ static int setClipRect(lua_State *L)
 	return 4;
 }
 
+constexpr char displayListMetatable[] = "DisplayList";
+
+static DisplayList *checkDisplayList(lua_State *L, int index)
+{
+	return (DisplayList *)luaL_checkudata(L, index, displayListMetatable);
+}
+
+static int checkDisplayListItem(lua_State *L, DisplayList *list, int index)
+{
+	int item = luaL_checkint(L, index) - 1;
+	if (item < 0 || item >= list->Size() || list->Get(item).kind == DisplayList::kindNone)
+	{
+		luaL_error(L, "Invalid display list item %d", item + 1);
+	}
+	return item;
+}
+
+static uint8_t clampColour(int value)
+{
+	return uint8_t(std::clamp(value, 0, 255));
+}
+
+static RGBA<uint8_t> optColour(lua_State *L, int index)
+{
+	return RGBA<uint8_t>(
+		clampColour(luaL_optint(L, index    , 255)),
+		clampColour(luaL_optint(L, index + 1, 255)),
+		clampColour(luaL_optint(L, index + 2, 255)),
+		clampColour(luaL_optint(L, index + 3, 255))
+	);
+}
+
+static int displayListAdd(lua_State *L, DisplayList::Item item)
+{
+	lua_pushinteger(L, checkDisplayList(L, 1)->Add(std::move(item)) + 1);
+	return 1;
+}
+
+static int displayListDrawText(lua_State *L)
+{
+	DisplayList::Item item;
+	item.kind = DisplayList::kindText;
+	item.pos = Vec2<int>(lua_tointeger(L, 2), lua_tointeger(L, 3));
+	item.text = tpt_lua_optString(L, 4, "");
+	item.colour = optColour(L, 5);
+	return displayListAdd(L, std::move(item));
+}
+
+static int displayListDrawPixel(lua_State *L)
+{
+	DisplayList::Item item;
+	item.kind = DisplayList::kindPixel;
+	item.pos = Vec2(luaL_optint(L, 2, 0), luaL_optint(L, 3, 0));
+	item.colour = optColour(L, 4);
+	return displayListAdd(L, std::move(item));
+}
+
+static int displayListDrawLine(lua_State *L)
+{
+	DisplayList::Item item;
+	item.kind = DisplayList::kindLine;
+	item.pos = Vec2<int>(lua_tointeger(L, 2), lua_tointeger(L, 3));
+	item.size = Vec2<int>(lua_tointeger(L, 4), lua_tointeger(L, 5)) - item.pos;
+	item.colour = optColour(L, 6);
+	return displayListAdd(L, std::move(item));
+}
+
+static int displayListShape(lua_State *L, DisplayList::Kind kind)
+{
+	DisplayList::Item item;
+	item.kind = kind;
+	item.pos = Vec2<int>(lua_tointeger(L, 2), lua_tointeger(L, 3));
+	item.size = Vec2<int>(lua_tointeger(L, 4), lua_tointeger(L, 5));
+	item.colour = optColour(L, 6);
+	return displayListAdd(L, std::move(item));
+}
+
+static int displayListDrawRect(lua_State *L)
+{
+	return displayListShape(L, DisplayList::kindRect);
+}
+
+static int displayListFillRect(lua_State *L)
+{
+	return displayListShape(L, DisplayList::kindFilledRect);
+}
+
+static int displayListDrawCircle(lua_State *L)
+{
+	return displayListShape(L, DisplayList::kindEllipse);
+}
+
+static int displayListFillCircle(lua_State *L)
+{
+	return displayListShape(L, DisplayList::kindFilledEllipse);
+}
+
+// Names of the fields that hold Item::size, depending on the kind of item
+static std::pair<const char *, const char *> sizeFields(DisplayList::Kind kind)
+{
+	switch (kind)
+	{
+	case DisplayList::kindLine:
+		return { "x2", "y2" };
+
+	case DisplayList::kindEllipse:
+	case DisplayList::kindFilledEllipse:
+		return { "rx", "ry" };
+
+	default:
+		break;
+	}
+	return { "w", "h" };
+}
+
+static int displayListSet(lua_State *L)
+{
+	auto *list = checkDisplayList(L, 1);
+	auto index = checkDisplayListItem(L, list, 2);
+	luaL_checktype(L, 3, LUA_TTABLE);
+	auto item = list->Get(index);
+	auto field = [L](const char *name, auto &&set) {
+		lua_getfield(L, 3, name);
+		if (!lua_isnil(L, -1))
+		{
+			set(-1);
+		}
+		lua_pop(L, 1);
+	};
+	// Lines keep their other end where it is when only the first end moves
+	auto end = item.pos + item.size;
+	field("x", [&](int i) { item.pos.X = lua_tointeger(L, i); });
+	field("y", [&](int i) { item.pos.Y = lua_tointeger(L, i); });
+	auto [ sizeX, sizeY ] = sizeFields(item.kind);
+	if (item.kind == DisplayList::kindLine)
+	{
+		field(sizeX, [&](int i) { end.X = lua_tointeger(L, i); });
+		field(sizeY, [&](int i) { end.Y = lua_tointeger(L, i); });
+		item.size = end - item.pos;
+	}
+	else
+	{
+		field(sizeX, [&](int i) { item.size.X = lua_tointeger(L, i); });
+		field(sizeY, [&](int i) { item.size.Y = lua_tointeger(L, i); });
+	}
+	field("r", [&](int i) { item.colour.Red   = clampColour(lua_tointeger(L, i)); });
+	field("g", [&](int i) { item.colour.Green = clampColour(lua_tointeger(L, i)); });
+	field("b", [&](int i) { item.colour.Blue  = clampColour(lua_tointeger(L, i)); });
+	field("a", [&](int i) { item.colour.Alpha = clampColour(lua_tointeger(L, i)); });
+	field("text", [&](int i) { item.text = tpt_lua_toString(L, i); });
+	field("visible", [&](int i) { item.visible = lua_toboolean(L, i); });
+	list->Set(index, std::move(item));
+	return 0;
+}
+
+static int displayListGet(lua_State *L)
+{
+	auto *list = checkDisplayList(L, 1);
+	auto &item = list->Get(checkDisplayListItem(L, list, 2));
+	auto name = tpt_lua_checkByteString(L, 3);
+	auto [ sizeX, sizeY ] = sizeFields(item.kind);
+	auto size = item.kind == DisplayList::kindLine ? item.pos + item.size : item.size;
+	if      (name == "x"    ) lua_pushinteger(L, item.pos.X);
+	else if (name == "y"    ) lua_pushinteger(L, item.pos.Y);
+	else if (name == sizeX  ) lua_pushinteger(L, size.X);
+	else if (name == sizeY  ) lua_pushinteger(L, size.Y);
+	else if (name == "r"    ) lua_pushinteger(L, item.colour.Red);
+	else if (name == "g"    ) lua_pushinteger(L, item.colour.Green);
+	else if (name == "b"    ) lua_pushinteger(L, item.colour.Blue);
+	else if (name == "a"    ) lua_pushinteger(L, item.colour.Alpha);
+	else if (name == "text" ) tpt_lua_pushString(L, item.text);
+	else if (name == "visible") lua_pushboolean(L, item.visible);
+	else return luaL_error(L, "Invalid display list item field %s", name.c_str());
+	return 1;
+}
+
+static int displayListRemove(lua_State *L)
+{
+	auto *list = checkDisplayList(L, 1);
+	list->Remove(checkDisplayListItem(L, list, 2));
+	return 0;
+}
+
+static int displayListClear(lua_State *L)
+{
+	checkDisplayList(L, 1)->Clear();
+	return 0;
+}
+
+static int displayListDraw(lua_State *L)
+{
+	auto *list = checkDisplayList(L, 1);
+	auto offset = Vec2(luaL_optint(L, 2, 0), luaL_optint(L, 3, 0));
+	std::visit([list, offset](auto p) {
+		list->Draw(*p, offset);
+	}, currentGraphics());
+	return 0;
+}
+
+static int displayListLen(lua_State *L)
+{
+	lua_pushinteger(L, checkDisplayList(L, 1)->Size());
+	return 1;
+}
+
+static int displayListGc(lua_State *L)
+{
+	checkDisplayList(L, 1)->~DisplayList();
+	return 0;
+}
+
+static int displayList(lua_State *L)
+{
+	new(lua_newuserdata(L, sizeof(DisplayList))) DisplayList();
+	luaL_getmetatable(L, displayListMetatable);
+	lua_setmetatable(L, -2);
+	return 1;
+}
+
 void LuaGraphics::Open(lua_State *L)
 {
 	static const luaL_Reg reg[] = {
@@ -292,9 +514,34 @@ void LuaGraphics::Open(lua_State *L)
 		LFUNC(getColors),
 		LFUNC(getHexColor),
 		LFUNC(setClipRect),
+		LFUNC(displayList),
 #undef LFUNC
 		{ NULL, NULL }
 	};
+	static const luaL_Reg displayListMethods[] = {
+		{ "drawText", displayListDrawText },
+		{ "drawPixel", displayListDrawPixel },
+		{ "drawLine", displayListDrawLine },
+		{ "drawRect", displayListDrawRect },
+		{ "fillRect", displayListFillRect },
+		{ "drawCircle", displayListDrawCircle },
+		{ "fillCircle", displayListFillCircle },
+		{ "set", displayListSet },
+		{ "get", displayListGet },
+		{ "remove", displayListRemove },
+		{ "clear", displayListClear },
+		{ "draw", displayListDraw },
+		{ NULL, NULL }
+	};
+	luaL_newmetatable(L, displayListMetatable);
+	lua_newtable(L);
+	luaL_register(L, NULL, displayListMethods);
+	lua_setfield(L, -2, "__index");
+	lua_pushcfunction(L, displayListLen);
+	lua_setfield(L, -2, "__len");
+	lua_pushcfunction(L, displayListGc);
+	lua_setfield(L, -2, "__gc");
+	lua_pop(L, 1);
 	lua_newtable(L);
 	luaL_register(L, NULL, reg);
 #define LCONSTAS(k, v) lua_pushinteger(L, int(v)); lua_setfield(L, -2, k)
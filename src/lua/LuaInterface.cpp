@@ -60,7 +60,7 @@ static int beginMessageBox(lua_State *L)
 		cb->Push(L);
 		if (lua_isfunction(L, -1))
 		{
-			if (tpt_lua_pcall(L, 0, 0, 0, eventTraitNone))
+			if (tpt_lua_pcall(L, 0, 0, 0, eventTraitNone, "interface.beginMessageBox"))
 			{
 				lsi->Log(CommandInterface::LogError, LuaGetError());
 			}
@@ -87,7 +87,7 @@ static int beginThrowError(lua_State *L)
 		cb->Push(L);
 		if (lua_isfunction(L, -1))
 		{
-			if (tpt_lua_pcall(L, 0, 0, 0, eventTraitNone))
+			if (tpt_lua_pcall(L, 0, 0, 0, eventTraitNone, "interface.beginThrowError"))
 			{
 				lsi->Log(CommandInterface::LogError, LuaGetError());
 			}
@@ -125,7 +125,7 @@ static int beginInput(lua_State *L)
 			{
 				lua_pushnil(L);
 			}
-			if (tpt_lua_pcall(L, 1, 0, 0, eventTraitNone))
+			if (tpt_lua_pcall(L, 1, 0, 0, eventTraitNone, "interface.beginInput"))
 			{
 				lsi->Log(CommandInterface::LogError, LuaGetError());
 			}
@@ -160,7 +160,7 @@ static int beginConfirm(lua_State *L)
 		if (lua_isfunction(L, -1))
 		{
 			lua_pushboolean(L, result);
-			if (tpt_lua_pcall(L, 1, 0, 0, eventTraitNone))
+			if (tpt_lua_pcall(L, 1, 0, 0, eventTraitNone, "interface.beginConfirm"))
 			{
 				lsi->Log(CommandInterface::LogError, LuaGetError());
 			}
@@ -9,6 +9,7 @@
 #include "gui/game/GameModel.h"
 #include "gui/game/GameView.h"
 #include "gui/interface/Engine.h"
+#include "prefs/GlobalPrefs.h"
 
 static int getUserName(lua_State *L)
 {
@@ -202,6 +203,143 @@ int setrecordinterval(lua_State* L)
 	return 0;
 }
 
+static int setrecordformat(lua_State *L)
+{
+	auto *lsi = GetLSI();
+	int acount = lua_gettop(L);
+	if (acount == 0)
+	{
+		auto codec = lsi->gameController->GetRecordingCodec();
+		if (!codec)
+		{
+			lua_pushnil(L);
+			return 1;
+		}
+		switch (*codec)
+		{
+		case FrameWriter::codecPPM  : lua_pushliteral(L, "ppm"  ); break;
+		case FrameWriter::codecPNG  : lua_pushliteral(L, "png"  ); break;
+		case FrameWriter::codecDelta: lua_pushliteral(L, "delta"); break;
+		}
+		return 1;
+	}
+	if (lua_isnil(L, 1))
+	{
+		lsi->gameController->SetRecordingCodec(std::nullopt);
+		return 0;
+	}
+	auto codec = FrameWriter::CodecFromName(tpt_lua_checkByteString(L, 1));
+	if (!codec)
+		return luaL_error(L, "invalid record format, expected ppm, png or delta");
+	lsi->gameController->SetRecordingCodec(*codec);
+	return 0;
+}
+
+static int profile(lua_State *L)
+{
+	auto *lsi = GetLSI();
+	int acount = lua_gettop(L);
+	if (acount == 0)
+	{
+		lua_pushboolean(L, lsi->profiler.Enabled());
+		lua_pushboolean(L, lsi->profiler.Sampling());
+		return 2;
+	}
+	if (lua_toboolean(L, 1))
+	{
+		lsi->profiler.Start(lua_toboolean(L, 2));
+	}
+	else
+	{
+		lsi->profiler.Stop();
+	}
+	return 0;
+}
+
+static double profileSeconds(LuaProfiler::Clock::duration duration)
+{
+	return std::chrono::duration<double>(duration).count();
+}
+
+static int profileresults(lua_State *L)
+{
+	auto *lsi = GetLSI();
+	auto &profiler = lsi->profiler;
+	lua_newtable(L);
+	lua_pushnumber(L, profileSeconds(profiler.Elapsed()));
+	lua_setfield(L, -2, "elapsed");
+	auto callbacks = profiler.Callbacks();
+	lua_createtable(L, int(callbacks.size()), 0);
+	for (auto i = 0; i < int(callbacks.size()); i++)
+	{
+		auto &[ name, callback ] = callbacks[i];
+		lua_createtable(L, 0, 4);
+		tpt_lua_pushByteString(L, name);
+		lua_setfield(L, -2, "name");
+		lua_pushnumber(L, double(callback.calls));
+		lua_setfield(L, -2, "calls");
+		lua_pushnumber(L, profileSeconds(callback.total));
+		lua_setfield(L, -2, "time");
+		lua_pushnumber(L, profileSeconds(callback.max));
+		lua_setfield(L, -2, "max");
+		lua_rawseti(L, -2, i + 1);
+	}
+	lua_setfield(L, -2, "callbacks");
+	auto lines = profiler.Lines();
+	lua_createtable(L, int(lines.size()), 0);
+	for (auto i = 0; i < int(lines.size()); i++)
+	{
+		auto &[ name, line ] = lines[i];
+		lua_createtable(L, 0, 3);
+		tpt_lua_pushByteString(L, name);
+		lua_setfield(L, -2, "line");
+		lua_pushnumber(L, double(line.samples));
+		lua_setfield(L, -2, "samples");
+		lua_pushnumber(L, profileSeconds(line.total));
+		lua_setfield(L, -2, "time");
+		lua_rawseti(L, -2, i + 1);
+	}
+	lua_setfield(L, -2, "lines");
+	if (lua_toboolean(L, 1))
+	{
+		profiler.Reset();
+	}
+	return 1;
+}
+
+static int profilereset(lua_State *L)
+{
+	GetLSI()->profiler.Reset();
+	return 0;
+}
+
+static int bytecodecache(lua_State *L)
+{
+	auto *lsi = GetLSI();
+	auto &cache = lsi->bytecodeCache;
+	if (lua_gettop(L))
+	{
+		cache.SetEnabled(lua_toboolean(L, 1));
+		GlobalPrefs::Ref().Set("LuaBytecodeCache", cache.GetEnabled());
+		return 0;
+	}
+	auto &stats = cache.GetStats();
+	lua_newtable(L);
+	lua_pushboolean(L, cache.GetEnabled());
+	lua_setfield(L, -2, "enabled");
+	lua_pushinteger(L, stats.hits);
+	lua_setfield(L, -2, "hits");
+	lua_pushinteger(L, stats.misses);
+	lua_setfield(L, -2, "misses");
+	lua_pushinteger(L, stats.rejected);
+	lua_setfield(L, -2, "rejected");
+	lua_pushnumber(L, double(stats.hitBytes));
+	lua_setfield(L, -2, "hitBytes");
+	lua_pushnumber(L, stats.loadUs / 1e6);
+	lua_setfield(L, -2, "loadTime");
+	return 1;
+}
+
 int set_bray_life_brightness_threshold(lua_State* L)
 {
 	auto *lsi = GetLSI();
@@ -313,8 +451,13 @@ void LuaMisc::Open(lua_State *L)
 		LFUNC(record),
 		LFUNC(record_subframe),
 		LFUNC(setrecordinterval),
+		LFUNC(setrecordformat),
 		LFUNC(set_bray_life_brightness_threshold),
 		LFUNC(debug),
+		LFUNC(profile),
+		LFUNC(profileresults),
+		LFUNC(profilereset),
+		LFUNC(bytecodecache),
 		LFUNC(autoreload_enable),
 		LFUNC(fpsCap),
 		LFUNC(drawCap),
@@ -331,6 +474,8 @@ void LuaMisc::Open(lua_State *L)
 	LCONST(DEBUG_LINES);
 	LCONST(DEBUG_PARTICLE);
 	LCONST(DEBUG_SURFNORM);
+	LCONST(DEBUG_LUAPROFILE);
+	LCONST(DEBUG_HTTP);
 #undef LCONST
 	{
 		lua_newtable(L);
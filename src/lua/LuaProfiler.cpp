@@ -0,0 +1,82 @@
+#include "LuaProfiler.h"
+#include <algorithm>
+
+void LuaProfiler::Start(bool withSampling)
+{
+	if (!enabled)
+	{
+		startedAt = Clock::now();
+	}
+	enabled = true;
+	sampling = withSampling;
+}
+
+void LuaProfiler::Stop()
+{
+	if (enabled)
+	{
+		elapsed += Clock::now() - startedAt;
+	}
+	enabled = false;
+}
+
+void LuaProfiler::Reset()
+{
+	callbacks.clear();
+	lines.clear();
+	elapsed = {};
+	startedAt = Clock::now();
+}
+
+LuaProfiler::Clock::duration LuaProfiler::Elapsed() const
+{
+	return elapsed + (enabled ? Clock::now() - startedAt : Clock::duration{});
+}
+
+void LuaProfiler::Enter()
+{
+	if (!depth)
+	{
+		// Time spent outside Lua is not attributed to any line.
+		lastSample = Clock::now();
+	}
+	depth++;
+}
+
+void LuaProfiler::Leave(const ByteString &callback, Clock::duration duration)
+{
+	depth--;
+	auto &entry = callbacks[callback];
+	entry.calls++;
+	entry.total += duration;
+	entry.max = std::max(entry.max, duration);
+}
+
+void LuaProfiler::Sample(const ByteString &line)
+{
+	auto now = Clock::now();
+	auto &entry = lines[line];
+	entry.samples++;
+	entry.total += now - lastSample;
+	lastSample = now;
+}
+
+template<class Entry>
+static std::vector<std::pair<ByteString, Entry>> byTotal(const std::map<ByteString, Entry> &entries)
+{
+	std::vector<std::pair<ByteString, Entry>> sorted(entries.begin(), entries.end());
+	std::stable_sort(sorted.begin(), sorted.end(), [](auto &lhs, auto &rhs) {
+		return lhs.second.total > rhs.second.total;
+	});
+	return sorted;
+}
+
+std::vector<std::pair<ByteString, LuaProfiler::Callback>> LuaProfiler::Callbacks() const
+{
+	return byTotal(callbacks);
+}
+
+std::vector<std::pair<ByteString, LuaProfiler::Line>> LuaProfiler::Lines() const
+{
+	return byTotal(lines);
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "common/String.h"
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+// Aggregates the time spent in Lua callbacks and, if sampling, the time spent
+// on each Lua source line. Does nothing unless started.
+class LuaProfiler
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	struct Callback
+	{
+		uint64_t calls = 0;
+		// Includes time spent in callbacks called from this one
+		Clock::duration total{};
+		Clock::duration max{};
+	};
+
+	struct Line
+	{
+		uint64_t samples = 0;
+		// Time since the previous sample, see Sample
+		Clock::duration total{};
+	};
+
+private:
+	bool enabled = false;
+	bool sampling = false;
+	int depth = 0;
+	Clock::time_point startedAt;
+	Clock::duration elapsed{};
+	Clock::time_point lastSample;
+	std::map<ByteString, Callback> callbacks;
+	std::map<ByteString, Line> lines;
+
+public:
+	void Start(bool withSampling);
+	void Stop();
+	void Reset();
+
+	bool Enabled() const
+	{
+		return enabled;
+	}
+
+	bool Sampling() const
+	{
+		return enabled && sampling;
+	}
+
+	// Wall time spent profiling, excluding time spent stopped.
+	Clock::duration Elapsed() const;
+
+	// Called around every call into Lua, see tpt_lua_pcall.
+	void Enter();
+	void Leave(const ByteString &callback, Clock::duration duration);
+
+	// Called from the instruction count hook; attributes the time since the
+	// previous sample (or since entering Lua) to line.
+	void Sample(const ByteString &line);
+
+	// Sorted by descending total time.
+	std::vector<std::pair<ByteString, Callback>> Callbacks() const;
+	std::vector<std::pair<ByteString, Line>> Lines() const;
+};
@@ -0,0 +1,77 @@
+#include "LuaProfilerDebug.h"
+#include "LuaProfiler.h"
+#include "gui/interface/Engine.h"
+#include "graphics/Graphics.h"
+#include <algorithm>
+
+constexpr auto maxCallbacks = 12;
+constexpr auto maxLines = 8;
+
+static double toMs(LuaProfiler::Clock::duration duration)
+{
+	return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+LuaProfilerDebug::LuaProfilerDebug(unsigned int id, const LuaProfiler &profiler):
+	DebugInfo(id),
+	profiler(profiler)
+{
+
+}
+
+void LuaProfilerDebug::Draw()
+{
+	Graphics * g = ui::Engine::Ref().g;
+
+	auto elapsed = std::max(toMs(profiler.Elapsed()), 1.0);
+	std::vector<String> text;
+	if (profiler.Enabled())
+	{
+		text.push_back(String::Build("Lua profiler: ", Format::Precision(elapsed / 1000.0, 1), "s"));
+		if (profiler.Sampling())
+		{
+			text.back() += String(", sampling");
+		}
+	}
+	else
+	{
+		text.push_back("Lua profiler stopped, start it with tpt.profile(true)");
+	}
+	auto callbacks = profiler.Callbacks();
+	for (auto i = 0; i < int(callbacks.size()) && i < maxCallbacks; i++)
+	{
+		auto &[ name, callback ] = callbacks[i];
+		text.push_back(String::Build(
+			Format::Precision(100.0 * toMs(callback.total) / elapsed, 1), "% ",
+			name.FromUtf8(), ": ", callback.calls, " calls, ",
+			Format::Precision(toMs(callback.total), 1), "ms, max ",
+			Format::Precision(toMs(callback.max), 2), "ms"
+		));
+	}
+	auto lines = profiler.Lines();
+	if (lines.size())
+	{
+		text.push_back("Hottest lines:");
+	}
+	for (auto i = 0; i < int(lines.size()) && i < maxLines; i++)
+	{
+		auto &[ name, line ] = lines[i];
+		text.push_back(String::Build(
+			Format::Precision(100.0 * toMs(line.total) / elapsed, 1), "% ",
+			name.FromUtf8(), ": ", line.samples, " samples"
+		));
+	}
+
+	int width = 0;
+	for (auto &str : text)
+	{
+		width = std::max(width, g->TextSize(str).X);
+	}
+	int x = 10, y = 30;
+	g->BlendFilledRect(RectSized(Vec2{ x - 3, y - 3 }, Vec2{ width + 6, int(text.size()) * 12 + 4 }), 0x000000_rgb .WithAlpha(180));
+	for (auto &str : text)
+	{
+		g->BlendText({ x, y }, str, 0xFFFFFF_rgb .WithAlpha(255));
+		y += 12;
+	}
+}
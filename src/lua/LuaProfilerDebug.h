@@ -0,0 +1,11 @@
+#pragma once
+#include "debug/DebugInfo.h"
+
+class LuaProfiler;
+class LuaProfilerDebug : public DebugInfo
+{
+	const LuaProfiler &profiler;
+public:
+	LuaProfilerDebug(unsigned int id, const LuaProfiler &profiler);
+	void Draw() override;
+};
@@ -10,9 +10,11 @@
 #include "gui/interface/Window.h"
 #include "LuaBit.h"
 #include "LuaComponent.h"
+#include "LuaProfilerDebug.h"
 #include "prefs/GlobalPrefs.h"
 #include "simulation/Simulation.h"
 #include "simulation/SimulationData.h"
+#include <iterator>
 
 static int atPanic(lua_State *L)
 {
@@ -78,6 +80,49 @@ static void hook(lua_State *L, lua_Debug * ar)
 		luaL_error(L, "Error: Script not responding");
 		lsi->luaExecutionStart = Platform::GetTime();
 	}
+	if (ar->event == LUA_HOOKCOUNT && lsi->profiler.Sampling() && lua_getinfo(L, "Sl", ar))
+	{
+		lsi->profiler.Sample(ByteString::Build(ar->short_src, ":", ar->currentline));
+	}
+}
+
+// Calls the function being replaced, the first upvalue, with the same arguments
+static int callReplaced(lua_State *L)
+{
+	lua_pushvalue(L, lua_upvalueindex(1));
+	lua_insert(L, 1);
+	lua_call(L, lua_gettop(L) - 1, LUA_MULTRET);
+	return lua_gettop(L);
+}
+
+static int cachedLoadfile(lua_State *L)
+{
+	// Reading from stdin and the extra arguments of 5.2 are left to the original
+	if (lua_gettop(L) != 1 || !lua_isstring(L, 1))
+	{
+		return callReplaced(L);
+	}
+	if (GetLSI()->bytecodeCache.LoadFile(L, tpt_lua_toByteString(L, 1)))
+	{
+		lua_pushnil(L);
+		lua_insert(L, -2);
+		return 2;
+	}
+	return 1;
+}
+
+static int cachedDofile(lua_State *L)
+{
+	if (lua_gettop(L) != 1 || !lua_isstring(L, 1))
+	{
+		return callReplaced(L);
+	}
+	if (GetLSI()->bytecodeCache.LoadFile(L, tpt_lua_toByteString(L, 1)))
+	{
+		return lua_error(L);
+	}
+	lua_call(L, 0, LUA_MULTRET);
+	return lua_gettop(L) - 1;
 }
 
 int LuaToLoggableString(lua_State *L, int n)
@@ -127,6 +172,7 @@ LuaScriptInterface::LuaScriptInterface(GameController *newGameController, GameMo
 {
 	auto &prefs = GlobalPrefs::Ref();
 	luaHookTimeout = prefs.Get("LuaHookTimeout", 3000);
+	bytecodeCache.SetEnabled(prefs.Get("LuaBytecodeCache", true));
 	for (auto moving = 0; moving < PT_NUM; ++moving)
 	{
 		for (auto into = 0; into < PT_NUM; ++into)
@@ -161,6 +207,14 @@ LuaScriptInterface::LuaScriptInterface(GameController *newGameController, GameMo
 		lua_setfield(L, -2, "exit");
 		lua_pop(L, 1);
 	}
+	{
+		lua_getglobal(L, "loadfile");
+		lua_pushcclosure(L, cachedLoadfile, 1);
+		lua_setglobal(L, "loadfile");
+		lua_getglobal(L, "dofile");
+		lua_pushcclosure(L, cachedDofile, 1);
+		lua_setglobal(L, "dofile");
+	}
 	{
 		lua_getglobal(L, "math");
 		lua_pushcfunction(L, mathRandom);
@@ -175,7 +229,8 @@ LuaScriptInterface::LuaScriptInterface(GameController *newGameController, GameMo
 		ref.Assign(L, -1);
 		lua_pop(L, 1);
 	}
-	if (luaL_loadbuffer(L, (const char *)compat_lua, compat_lua_size, "@[built-in compat.lua]") || tpt_lua_pcall(L, 0, 0, 0, eventTraitNone))
+	gameController->AddDebugInfo(std::make_unique<LuaProfilerDebug>(DEBUG_LUAPROFILE, profiler));
+	if (bytecodeCache.LoadBuffer(L, (const char *)compat_lua, compat_lua_size, "@[built-in compat.lua]") || tpt_lua_pcall(L, 0, 0, 0, eventTraitNone))
 	{
 		throw std::runtime_error(ByteString("failed to load built-in compat: ") + tpt_lua_toByteString(L, -1));
 	}
@@ -203,7 +258,7 @@ void CommandInterface::Init()
 	auto *L = lsi->L;
 	if (Platform::FileExists("autorun.lua"))
 	{
-		if(luaL_loadfile(L, "autorun.lua") || tpt_lua_pcall(L, 0, 0, 0, eventTraitNone))
+		if(lsi->bytecodeCache.LoadFile(L, "autorun.lua") || tpt_lua_pcall(L, 0, 0, 0, eventTraitNone))
 			Log(CommandInterface::LogError, LuaGetError());
 		else
 			Log(CommandInterface::LogWarning, "Loaded autorun.lua");
@@ -293,11 +348,11 @@ void LuaSetParticleProperty(lua_State *L, int particleID, StructProperty propert
 	auto *sim = lsi->sim;
 	if (property.Name == "type")
 	{
-		sim->part_change_type(particleID, int(sim->parts[particleID].x+0.5f), int(sim->parts[particleID].y+0.5f), luaL_checkinteger(L, 3));
+		sim->part_change_type(particleID, int(sim->parts[particleID].x+0.5f), int(sim->parts[particleID].y+0.5f), luaL_checkinteger(L, stackPos));
 	}
 	else if (property.Name == "x" || property.Name == "y")
 	{
-		float val = luaL_checknumber(L, 3);
+		float val = luaL_checknumber(L, stackPos);
 		float x = sim->parts[particleID].x;
 		float y = sim->parts[particleID].y;
 		float nx = property.Name == "x" ? val : x;
@@ -375,6 +430,26 @@ static int pushGameControllerEvent(lua_State *L, const GameControllerEvent &even
 	return 0;
 }
 
+// Indexed by GameControllerEvent alternative, names match the event.* constants
+static const char *const gameControllerEventNames[] = {
+	"event.textinput",
+	"event.textediting",
+	"event.keypress",
+	"event.keyrelease",
+	"event.mousedown",
+	"event.mouseup",
+	"event.mousemove",
+	"event.mousewheel",
+	"event.tick",
+	"event.blur",
+	"event.close",
+	"event.beforesim",
+	"event.aftersim",
+	"event.beforesimdraw",
+	"event.aftersimdraw",
+};
+static_assert(std::size(gameControllerEventNames) == std::variant_size_v<GameControllerEvent>);
+
 bool CommandInterface::HandleEvent(const GameControllerEvent &event)
 {
 	auto *lsi = static_cast<LuaScriptInterface *>(this);
@@ -388,7 +463,7 @@ bool CommandInterface::HandleEvent(const GameControllerEvent &event)
 		int numArgs = pushGameControllerEvent(L, event);
 		int callret = tpt_lua_pcall(L, numArgs, 1, 0, std::visit([](auto &event) {
 			return event.traits;
-		}, event));
+		}, event), gameControllerEventNames[event.index()]);
 		if (callret)
 		{
 			if (LuaGetError() == "Error: Script not responding")
@@ -771,27 +846,60 @@ bool tpt_lua_equalsString(lua_State *L, int index, const char *data, size_t size
 	return lua_isstring(L, index) && lua_objlen(L, index) == size && !memcmp(lua_tostring(L, index), data, size);
 }
 
-int tpt_lua_pcall(lua_State *L, int numArgs, int numResults, int errorFunc, EventTraits newEventTraits)
+static ByteString profileCallbackName(lua_State *L, int numArgs, const char *profileName, int profileElement)
+{
+	auto name = ByteString(profileName ? profileName : "call");
+	if (profileElement >= 0 && profileElement < PT_NUM)
+	{
+		auto &sd = SimulationData::CRef();
+		return sd.elements[profileElement].Identifier + " " + name;
+	}
+	lua_Debug ar;
+	lua_pushvalue(L, -(numArgs + 1));
+	if (lua_getinfo(L, ">S", &ar))
+	{
+		return ByteString::Build(name, " ", ar.short_src, ":", ar.linedefined);
+	}
+	return name;
+}
+
+int tpt_lua_pcall(lua_State *L, int numArgs, int numResults, int errorFunc, EventTraits newEventTraits, const char *profileName, int profileElement)
 {
 	auto *lsi = GetLSI();
 	lsi->luaExecutionStart = Platform::GetTime();
 	struct AtReturn
 	{
 		EventTraits oldEventTraits;
+		bool profiling;
+		ByteString profileCallback;
+		LuaProfiler::Clock::time_point profileStart;
 
-		AtReturn(EventTraits newEventTraits)
+		AtReturn(EventTraits newEventTraits, bool newProfiling) : profiling(newProfiling)
 		{
 			auto *lsi = GetLSI();
 			oldEventTraits = lsi->eventTraits;
 			lsi->eventTraits = newEventTraits;
+			if (profiling)
+			{
+				lsi->profiler.Enter();
+			}
 		}
 
 		~AtReturn()
 		{
 			auto *lsi = GetLSI();
 			lsi->eventTraits = oldEventTraits;
+			if (profiling)
+			{
+				lsi->profiler.Leave(profileCallback, LuaProfiler::Clock::now() - profileStart);
+			}
 		}
-	} atReturn(newEventTraits);
+	} atReturn(newEventTraits, lsi->profiler.Enabled());
+	if (atReturn.profiling)
+	{
+		atReturn.profileCallback = profileCallbackName(L, numArgs, profileName, profileElement);
+		atReturn.profileStart = LuaProfiler::Clock::now();
+	}
 	return lua_pcall(L, numArgs, numResults, errorFunc);
 }
 
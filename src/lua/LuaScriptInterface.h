@@ -1,5 +1,7 @@
 #pragma once
+#include "LuaBytecodeCache.h"
 #include "LuaCompat.h"
+#include "LuaProfiler.h"
 #include "LuaSmartRef.h"
 #include "CommandInterface.h"
 #include "gui/game/GameControllerEvents.h"
@@ -47,10 +49,22 @@ enum UpdateMode
 	NUM_UPDATEMODES,
 };
 
+enum BatchMode
+{
+	BATCH_FRAME, // once per update loop, with every particle of the element
+	BATCH_RUN, // once per run of particles of the element with consecutive IDs
+	NUM_BATCHMODES,
+};
+
 struct CustomElement
 {
 	UpdateMode updateMode = UPDATE_AFTER;
 	LuaSmartRef update;
+	BatchMode batchMode = BATCH_FRAME;
+	LuaSmartRef batchUpdate;
+	// Particles up to batchEnd have been handed to batchUpdate in update loop batchLoop
+	uint64_t batchLoop = 0;
+	int batchEnd = -1;
 	LuaSmartRef graphics;
 	LuaSmartRef ctypeDraw;
 	LuaSmartRef create;
@@ -73,6 +87,7 @@ public:
 	Renderer *ren;
 
 	std::vector<CustomElement> customElements; // must come after luaState
+	std::vector<int> batchUpdateIds;
 
 	EventTraits eventTraits = eventTraitNone;
 
@@ -82,12 +97,15 @@ public:
 	bool currentCommand = false;
 	int textInputRefcount = 0;
 	long unsigned int luaExecutionStart = 0;
+	LuaProfiler profiler;
 
 	std::vector<LuaSmartRef> gameControllerEventHandlers; // must come after luaState
 	std::unique_ptr<http::Request> scriptManagerDownload;
 	int luaHookTimeout;
+	LuaBytecodeCache bytecodeCache;
 
 	std::map<LuaComponent *, LuaSmartRef> grabbedComponents; // must come after luaState
+	LuaSmartRef particlePropertyIndices; // particle property and alias names to FIELD_* values, must come after luaState
 
 	LuaScriptInterface(GameController *newGameController, GameModel *newGameModel);
 	~LuaScriptInterface();
@@ -123,7 +141,9 @@ bool tpt_lua_equalsLiteral(lua_State *L, int index, const char (&lit)[N])
 	return tpt_lua_equalsString(L, index, lit, N - 1U);
 }
 
-int tpt_lua_pcall(lua_State *L, int numArgs, int numResults, int errorFunc, EventTraits eventTraits);
+// While profiling, the time spent in the call is attributed to profileName and
+// the function's source location, or to the element profileElement if given.
+int tpt_lua_pcall(lua_State *L, int numArgs, int numResults, int errorFunc, EventTraits eventTraits, const char *profileName = nullptr, int profileElement = -1);
 
 namespace LuaHttp
 {
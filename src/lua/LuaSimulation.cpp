@@ -14,6 +14,11 @@
 #include "simulation/gravity/Gravity.h"
 #include "simulation/Snapshot.h"
 #include "simulation/ToolClasses.h"
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <optional>
 #include <type_traits>
 
 static int ambientHeatSim(lua_State *L)
@@ -392,6 +397,44 @@ static int partPosition(lua_State *L)
 	}
 }
 
+// Resolves a particle property given as a FIELD_* constant or a name,
+// raises a Lua error if there is no such property. Names are looked up in
+// a table built once in Open, so scripts that keep passing strings pay for
+// a table access rather than a search through the property list.
+static std::vector<StructProperty>::const_iterator checkParticleProperty(lua_State *L, int index)
+{
+	auto &properties = Particle::GetProperties();
+	int fieldID;
+	if (lua_type(L, index) == LUA_TNUMBER)
+	{
+		fieldID = lua_tointeger(L, index);
+		if (fieldID < 0 || fieldID >= (int)properties.size())
+			luaL_error(L, "Invalid field ID (%d)", fieldID);
+	}
+	else if (lua_type(L, index) == LUA_TSTRING)
+	{
+		GetLSI()->particlePropertyIndices.Push(L);
+		lua_pushvalue(L, index);
+		lua_rawget(L, -2);
+		if (lua_type(L, -1) != LUA_TNUMBER)
+			luaL_error(L, "Unknown field (%s)", lua_tostring(L, index));
+		fieldID = lua_tointeger(L, -1);
+		lua_pop(L, 2);
+	}
+	else
+	{
+		luaL_error(L, "Field ID must be an name (string) or identifier (integer)");
+	}
+	return properties.begin() + fieldID;
+}
+
+static int property(lua_State *L)
+{
+	auto &properties = Particle::GetProperties();
+	lua_pushinteger(L, checkParticleProperty(L, 1) - properties.begin());
+	return 1;
+}
+
 static int partProperty(lua_State *L)
 {
 	auto *lsi = GetLSI();
@@ -412,51 +455,351 @@ static int partProperty(lua_State *L)
 		}
 	}
 
+	auto prop = checkParticleProperty(L, 2);
+
+	//Calculate memory address of property
+	intptr_t propertyAddress = (intptr_t)(((unsigned char*)&lsi->sim->parts[particleID]) + prop->Offset);
+
+	if (argCount == 3)
+	{
+		LuaSetParticleProperty(L, particleID, *prop, propertyAddress, 3);
+		return 0;
+	}
+	else
+	{
+		LuaGetProperty(L, *prop, propertyAddress);
+		return 1;
+	}
+}
+
+// Views index straight into simulation arrays: no copying, and no allocation
+// per access. Particle views are indexed by particle ID, pmap and photons by
+// y * XRES + x, cell planes by y * XCELLS + x. Every access is bounds-checked,
+// and views stop working once particle IDs may have changed meaning, see
+// Simulation::particleIdGeneration.
+namespace
+{
+	constexpr char viewMetatable[] = "SimulationView";
+
+	enum ViewKind
+	{
+		viewPart,
+		viewPmap,
+		viewPhotons,
+		viewCell,
+	};
+
+	struct CellPlane
+	{
+		const char *name;
+		bool writable;
+		float minValue, maxValue;
+		float *(*data)(Simulation *sim);
+	};
+
+	// gravmap is rebuilt from particles on every gravity update, so writes would not stick
+	const std::array<CellPlane, 7> cellPlanes = {{
+		{ "pressure"     , true , MIN_PRESSURE, MAX_PRESSURE, [](Simulation *sim) { return &sim->pv[0][0]; } },
+		{ "velocityX"    , true , MIN_PRESSURE, MAX_PRESSURE, [](Simulation *sim) { return &sim->vx[0][0]; } },
+		{ "velocityY"    , true , MIN_PRESSURE, MAX_PRESSURE, [](Simulation *sim) { return &sim->vy[0][0]; } },
+		{ "ambientHeat"  , true , MIN_TEMP    , MAX_TEMP    , [](Simulation *sim) { return &sim->hv[0][0]; } },
+		{ "gravityMass"  , false, 0           , 0           , [](Simulation *sim) { return sim->gravmap; } },
+		{ "gravityFieldX", false, 0           , 0           , [](Simulation *sim) { return sim->gravx; } },
+		{ "gravityFieldY", false, 0           , 0           , [](Simulation *sim) { return sim->gravy; } },
+	}};
+
+	struct LuaView
+	{
+		ViewKind kind;
+		int item; // particle property or cell plane
+		int size;
+		uint64_t generation;
+	};
+}
+
+static void pushView(lua_State *L, ViewKind kind, int item, int size)
+{
+	auto *view = (LuaView *)lua_newuserdata(L, sizeof(LuaView));
+	view->kind = kind;
+	view->item = item;
+	view->size = size;
+	view->generation = GetLSI()->sim->particleIdGeneration;
+	luaL_getmetatable(L, viewMetatable);
+	lua_setmetatable(L, -2);
+}
+
+static LuaView &checkViewAccess(lua_State *L, int &index)
+{
+	auto *view = (LuaView *)luaL_checkudata(L, 1, viewMetatable);
+	if (view->generation != GetLSI()->sim->particleIdGeneration)
+	{
+		luaL_error(L, "view invalidated by a load, restore or particle order reload, get a new one");
+	}
+	index = luaL_checkint(L, 2);
+	if (index < 0 || index >= view->size)
+	{
+		luaL_error(L, "index %d out of range", index);
+	}
+	return *view;
+}
+
+static int viewIndex(lua_State *L)
+{
+	int index;
+	auto &view = checkViewAccess(L, index);
+	auto *sim = GetLSI()->sim;
+	switch (view.kind)
+	{
+	case viewPart:
+	{
+		auto &prop = Particle::GetProperties()[view.item];
+		LuaGetProperty(L, prop, intptr_t(((unsigned char *)&sim->parts[index]) + prop.Offset));
+		break;
+	}
+
+	case viewPmap:
+		lua_pushinteger(L, (&sim->pmap[0][0])[index]);
+		break;
+
+	case viewPhotons:
+		lua_pushinteger(L, (&sim->photons[0][0])[index]);
+		break;
+
+	case viewCell:
+		lua_pushnumber(L, cellPlanes[view.item].data(sim)[index]);
+		break;
+	}
+	return 1;
+}
+
+static int viewNewIndex(lua_State *L)
+{
+	int index;
+	auto &view = checkViewAccess(L, index);
+	auto *sim = GetLSI()->sim;
+	switch (view.kind)
+	{
+	case viewPart:
+		// Same rules as partProperty: writes to empty slots are ignored
+		if (sim->parts[index].type)
+		{
+			auto &prop = Particle::GetProperties()[view.item];
+			LuaSetParticleProperty(L, index, prop, intptr_t(((unsigned char *)&sim->parts[index]) + prop.Offset), 3);
+		}
+		break;
+
+	case viewCell:
+		if (cellPlanes[view.item].writable)
+		{
+			auto &plane = cellPlanes[view.item];
+			plane.data(sim)[index] = std::clamp(float(luaL_checknumber(L, 3)), plane.minValue, plane.maxValue);
+			break;
+		}
+		[[fallthrough]];
+
+	default:
+		return luaL_error(L, "view is read-only");
+	}
+	return 0;
+}
+
+static int viewLen(lua_State *L)
+{
+	auto *view = (LuaView *)luaL_checkudata(L, 1, viewMetatable);
+	lua_pushinteger(L, view->size);
+	return 1;
+}
+
+static int partView(lua_State *L)
+{
 	auto &properties = Particle::GetProperties();
-	auto prop = properties.end();
+	auto prop = checkParticleProperty(L, 1);
+	pushView(L, viewPart, int(prop - properties.begin()), NPART);
+	return 1;
+}
 
-	//Get field
-	if (lua_type(L, 2) == LUA_TNUMBER)
+static int mapView(lua_State *L)
+{
+	auto name = tpt_lua_checkByteString(L, 1);
+	if (name == "pmap")
 	{
-		int fieldID = lua_tointeger(L, 2);
-		if (fieldID < 0 || fieldID >= (int)properties.size())
-			return luaL_error(L, "Invalid field ID (%d)", fieldID);
-		prop = properties.begin() + fieldID;
+		pushView(L, viewPmap, 0, XRES * YRES);
+		return 1;
 	}
-	else if (lua_type(L, 2) == LUA_TSTRING)
+	if (name == "photons")
 	{
-		ByteString fieldName = tpt_lua_toByteString(L, 2);
-		for (auto &alias : Particle::GetPropertyAliases())
+		pushView(L, viewPhotons, 0, XRES * YRES);
+		return 1;
+	}
+	for (auto i = 0; i < int(cellPlanes.size()); i++)
+	{
+		if (name == cellPlanes[i].name)
 		{
-			if (fieldName == alias.from)
-			{
-				fieldName = alias.to;
-			}
+			pushView(L, viewCell, i, XCELLS * YCELLS);
+			return 1;
 		}
-		prop = std::find_if(properties.begin(), properties.end(), [&fieldName](StructProperty const &p) {
-			return p.Name == fieldName;
-		});
-		if (prop == properties.end())
-			return luaL_error(L, "Unknown field (%s)", fieldName.c_str());
 	}
-	else
+	return luaL_error(L, "Unknown map (%s)", name.c_str());
+}
+
+// For each pixel of the region, row by row, the particle that tools would
+// target: the one at the selected stack edit depth if stack edit is in use,
+// the one sim.partID returns otherwise. -1 where there is none.
+static std::vector<int> regionParticles(Simulation *sim, Rect<int> region)
+{
+	auto size = region.Size();
+	std::vector<int> ids(size.X * size.Y, -1);
+	auto index = [region, size](Vec2<int> p) {
+		return (p.Y - region.TopLeft.Y) * size.X + (p.X - region.TopLeft.X);
+	};
+	if (sim->stackEditDepth >= 0)
 	{
-		return luaL_error(L, "Field ID must be an name (string) or identifier (integer)");
+		// Same choice as Simulation::GetStackEditParticleId, for every pixel in one pass
+		std::vector<int> depth(ids.size(), 0);
+		for (int i = sim->parts_lastActiveIndex; i >= 0; i--)
+		{
+			if (!sim->parts[i].type)
+				continue;
+			auto p = Vec2{ int(sim->parts[i].x + 0.5f), int(sim->parts[i].y + 0.5f) };
+			if (!region.Contains(p))
+				continue;
+			auto k = index(p);
+			if (depth[k] <= sim->stackEditDepth)
+				ids[k] = i;
+			depth[k]++;
+		}
+		return ids;
+	}
+	for (auto p : RES.OriginRect() & region)
+	{
+		int r = sim->pmap[p.Y][p.X];
+		if (!r)
+			r = sim->photons[p.Y][p.X];
+		if (r)
+			ids[index(p)] = ID(r);
 	}
+	return ids;
+}
 
-	//Calculate memory address of property
-	intptr_t propertyAddress = (intptr_t)(((unsigned char*)&lsi->sim->parts[particleID]) + prop->Offset);
+static Rect<int> checkRegion(lua_State *L)
+{
+	auto pos = Vec2{ luaL_checkint(L, 1), luaL_checkint(L, 2) };
+	auto size = Vec2{ luaL_checkint(L, 3), luaL_checkint(L, 4) };
+	if (size.X < 0 || size.Y < 0 || size.X > XRES || size.Y > YRES)
+	{
+		luaL_error(L, "Invalid region size (%d, %d)", size.X, size.Y);
+	}
+	return RectSized(pos, size);
+}
 
-	if (argCount == 3)
+// A field or a table of fields
+static std::vector<std::vector<StructProperty>::const_iterator> checkRegionFields(lua_State *L, int index)
+{
+	std::vector<std::vector<StructProperty>::const_iterator> fields;
+	if (lua_type(L, index) == LUA_TTABLE)
 	{
-		LuaSetParticleProperty(L, particleID, *prop, propertyAddress, 3);
-		return 0;
+		auto count = int(lua_objlen(L, index));
+		for (auto i = 1; i <= count; i++)
+		{
+			lua_rawgeti(L, index, i);
+			fields.push_back(checkParticleProperty(L, lua_gettop(L)));
+			lua_pop(L, 1);
+		}
 	}
 	else
 	{
-		LuaGetProperty(L, *prop, propertyAddress);
-		return 1;
+		fields.push_back(checkParticleProperty(L, index));
 	}
+	return fields;
+}
+
+static int readRegion(lua_State *L)
+{
+	auto *sim = GetLSI()->sim;
+	auto region = checkRegion(L);
+	auto fields = checkRegionFields(L, 5);
+	auto ids = regionParticles(sim, region);
+	auto fieldCount = int(fields.size());
+	lua_createtable(L, int(ids.size()) * fieldCount, 0);
+	auto n = 1;
+	for (auto id : ids)
+	{
+		for (auto &prop : fields)
+		{
+			if (id >= 0)
+				LuaGetProperty(L, *prop, intptr_t(((unsigned char *)&sim->parts[id]) + prop->Offset));
+			else
+				lua_pushinteger(L, 0);
+			lua_rawseti(L, -2, n++);
+		}
+	}
+	return 1;
+}
+
+static int writeRegion(lua_State *L)
+{
+	auto *sim = GetLSI()->sim;
+	auto region = checkRegion(L);
+	auto fields = checkRegionFields(L, 5);
+	luaL_checktype(L, 6, LUA_TTABLE);
+	auto fieldCount = int(fields.size());
+	auto typeField = -1;
+	for (auto f = 0; f < fieldCount; f++)
+	{
+		if (fields[f]->Name == "type")
+			typeField = f;
+	}
+	// Selected up front so that type changes and moves don't affect which
+	// particles the rest of the region refers to
+	auto ids = regionParticles(sim, region);
+	auto written = 0;
+	for (auto k = 0; k < int(ids.size()); k++)
+	{
+		auto id = ids[k];
+		auto base = k * fieldCount + 1;
+		if (typeField >= 0)
+		{
+			lua_rawgeti(L, 6, base + typeField);
+			if (lua_type(L, -1) == LUA_TNUMBER)
+			{
+				auto type = lua_tointeger(L, -1);
+				auto p = region.TopLeft + Vec2{ k % region.Size().X, k / region.Size().X };
+				if (id >= 0 && !type)
+				{
+					sim->kill_part(id);
+					written++;
+					id = -1;
+				}
+				else if (id >= 0 && type != sim->parts[id].type)
+				{
+					LuaSetParticleProperty(L, id, *fields[typeField], intptr_t(((unsigned char *)&sim->parts[id]) + fields[typeField]->Offset), -1);
+				}
+				else if (id < 0 && type && RES.OriginRect().Contains(p))
+				{
+					id = sim->create_part(-1, p.X, p.Y, type);
+				}
+			}
+			lua_pop(L, 1);
+		}
+		if (id < 0 || !sim->parts[id].type)
+			continue;
+		for (auto f = 0; f < fieldCount; f++)
+		{
+			if (f == typeField)
+				continue;
+			lua_rawgeti(L, 6, base + f);
+			// nil leaves the field alone
+			if (!lua_isnil(L, -1))
+			{
+				auto &prop = *fields[f];
+				LuaSetParticleProperty(L, id, prop, intptr_t(((unsigned char *)&sim->parts[id]) + prop.Offset), -1);
+			}
+			lua_pop(L, 1);
+		}
+		written++;
+	}
+	lua_pushinteger(L, written);
+	return 1;
 }
 
 static int partKill(lua_State *L)
@@ -1378,10 +1721,131 @@ static int neighbors(lua_State *L)
 	return 1;
 }
 
+namespace
+{
+	constexpr char partsFilterMetatable[] = "PartsFilter";
+
+	struct PartsFilter
+	{
+		std::bitset<PT_NUM> types;
+		bool anyType = true;
+		std::optional<Rect<int>> rect;
+		// Particles at the requested stack depth when the iterator was made,
+		// empty if there is no depth filter
+		std::vector<bool> atDepth;
+
+		bool Matches(const Particle &part, int i) const
+		{
+			if (!anyType && !types[part.type])
+				return false;
+			if (rect && !rect->Contains({ int(part.x + 0.5f), int(part.y + 0.5f) }))
+				return false;
+			if (atDepth.size() && !atDepth[i])
+				return false;
+			return true;
+		}
+	};
+}
+
+static int partsFilterGc(lua_State *L)
+{
+	auto *filter = (PartsFilter *)luaL_checkudata(L, 1, partsFilterMetatable);
+	filter->~PartsFilter();
+	return 0;
+}
+
+static int partsFilteredClosure(lua_State *L)
+{
+	auto *lsi = GetLSI();
+	auto *filter = (PartsFilter *)lua_touserdata(L, lua_upvalueindex(2));
+	for (int i = lua_tointeger(L, lua_upvalueindex(1)); i <= lsi->sim->parts_lastActiveIndex; ++i)
+	{
+		if (lsi->sim->parts[i].type && filter->Matches(lsi->sim->parts[i], i))
+		{
+			lua_pushnumber(L, i + 1);
+			lua_replace(L, lua_upvalueindex(1));
+			lua_pushnumber(L, i);
+			return 1;
+		}
+	}
+	return 0;
+}
+
 static int parts(lua_State *L)
 {
+	if (lua_isnoneornil(L, 1))
+	{
+		lua_pushnumber(L, 0);
+		lua_pushcclosure(L, partsClosure, 1);
+		return 1;
+	}
+	luaL_checktype(L, 1, LUA_TTABLE);
+	auto *sim = GetLSI()->sim;
 	lua_pushnumber(L, 0);
-	lua_pushcclosure(L, partsClosure, 1);
+	auto *filter = new(lua_newuserdata(L, sizeof(PartsFilter))) PartsFilter();
+	luaL_getmetatable(L, partsFilterMetatable);
+	lua_setmetatable(L, -2);
+
+	auto addType = [L, filter](int index) {
+		int type = luaL_checkint(L, index);
+		if (type < 0 || type >= PT_NUM)
+			luaL_error(L, "Invalid element");
+		filter->types[type] = true;
+		filter->anyType = false;
+	};
+	lua_getfield(L, 1, "type");
+	if (lua_type(L, -1) == LUA_TTABLE)
+	{
+		auto count = int(lua_objlen(L, -1));
+		for (auto i = 1; i <= count; i++)
+		{
+			lua_rawgeti(L, -1, i);
+			addType(lua_gettop(L));
+			lua_pop(L, 1);
+		}
+	}
+	else if (!lua_isnil(L, -1))
+	{
+		addType(lua_gettop(L));
+	}
+	lua_pop(L, 1);
+
+	lua_getfield(L, 1, "rect");
+	if (!lua_isnil(L, -1))
+	{
+		luaL_checktype(L, -1, LUA_TTABLE);
+		int r[4];
+		for (auto i = 0; i < 4; i++)
+		{
+			lua_rawgeti(L, -1, i + 1);
+			r[i] = luaL_checkint(L, lua_gettop(L));
+			lua_pop(L, 1);
+		}
+		filter->rect = RectSized(Vec2{ r[0], r[1] }, Vec2{ r[2], r[3] });
+	}
+	lua_pop(L, 1);
+
+	lua_getfield(L, 1, "depth");
+	if (!lua_isnil(L, -1))
+	{
+		// Depth 0 is the top of the stack, as with stack edit
+		int depth = luaL_checkint(L, lua_gettop(L));
+		filter->atDepth.resize(NPART, false);
+		std::vector<int> count(XRES * YRES, 0);
+		for (int i = sim->parts_lastActiveIndex; i >= 0; i--)
+		{
+			if (!sim->parts[i].type)
+				continue;
+			auto p = Vec2{ int(sim->parts[i].x + 0.5f), int(sim->parts[i].y + 0.5f) };
+			if (!RES.OriginRect().Contains(p))
+				continue;
+			if (count[p.Y * XRES + p.X]++ == depth)
+				filter->atDepth[i] = true;
+		}
+	}
+	lua_pop(L, 1);
+
+	lua_pushcclosure(L, partsFilteredClosure, 2);
 	return 1;
 }
 
@@ -1881,6 +2345,11 @@ void LuaSimulation::Open(lua_State *L)
 		LFUNC(partChangeType),
 		LFUNC(partCreate),
 		LFUNC(partProperty),
+		LFUNC(readRegion),
+		LFUNC(writeRegion),
+		LFUNC(property),
+		LFUNC(partView),
+		LFUNC(mapView),
 		LFUNC(partPosition),
 		LFUNC(partID),
 		LFUNC(partKill),
@@ -1966,6 +2435,18 @@ void LuaSimulation::Open(lua_State *L)
 #undef LFUNC
 		{ NULL, NULL }
 	};
+	luaL_newmetatable(L, partsFilterMetatable);
+	lua_pushcfunction(L, partsFilterGc);
+	lua_setfield(L, -2, "__gc");
+	lua_pop(L, 1);
+	luaL_newmetatable(L, viewMetatable);
+	lua_pushcfunction(L, viewIndex);
+	lua_setfield(L, -2, "__index");
+	lua_pushcfunction(L, viewNewIndex);
+	lua_setfield(L, -2, "__newindex");
+	lua_pushcfunction(L, viewLen);
+	lua_setfield(L, -2, "__len");
+	lua_pop(L, 1);
 	lua_newtable(L);
 	luaL_register(L, NULL, reg);
 
@@ -2087,6 +2568,25 @@ void LuaSimulation::Open(lua_State *L)
 			lua_settable(L, -3);
 		}
 	}
+	{
+		lua_newtable(L);
+		int particlePropertiesCount = 0;
+		for (auto &prop : Particle::GetProperties())
+		{
+			tpt_lua_pushByteString(L, prop.Name);
+			lua_pushinteger(L, particlePropertiesCount++);
+			lua_rawset(L, -3);
+		}
+		for (auto &alias : Particle::GetPropertyAliases())
+		{
+			tpt_lua_pushByteString(L, alias.from);
+			tpt_lua_pushByteString(L, alias.to);
+			lua_rawget(L, -3);
+			lua_rawset(L, -3);
+		}
+		lsi->particlePropertyIndices.Assign(L, -1);
+		lua_pop(L, 1);
+	}
 	{
 		lua_newtable(L);
 		for (int i = 1; i <= MAXSIGNS; i++)
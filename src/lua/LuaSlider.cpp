@@ -71,7 +71,7 @@ void LuaSlider::triggerOnValueChanged()
 		lua_rawgeti(L, LUA_REGISTRYINDEX, onValueChangedFunction);
 		lua_rawgeti(L, LUA_REGISTRYINDEX, owner_ref);
 		lua_pushinteger(L, slider->GetValue());
-		if (tpt_lua_pcall(L, 2, 0, 0, eventTraitNone))
+		if (tpt_lua_pcall(L, 2, 0, 0, eventTraitNone, "slider.onValueChanged"))
 		{
 			ci->Log(CommandInterface::LogError, tpt_lua_toString(L, -1));
 		}
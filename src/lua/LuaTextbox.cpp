@@ -59,7 +59,7 @@ void LuaTextbox::triggerOnTextChanged()
 	{
 		lua_rawgeti(L, LUA_REGISTRYINDEX, onTextChangedFunction);
 		lua_rawgeti(L, LUA_REGISTRYINDEX, owner_ref);
-		if (tpt_lua_pcall(L, 1, 0, 0, eventTraitNone))
+		if (tpt_lua_pcall(L, 1, 0, 0, eventTraitNone, "textbox.onTextChanged"))
 		{
 			ci->Log(CommandInterface::LogError, tpt_lua_optString(L, -1));
 		}
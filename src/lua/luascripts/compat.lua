@@ -550,6 +550,7 @@ function tpt.set_property(prop, value, ...)
 	if type(value) == "string" then
 		value = tpt.element(value)
 	end
+	prop = sim.property(prop)
 	local argc = select("#", ...)
 	local filter = argc > 0 and select(argc, ...)
 	local have_filter = type(filter) == "string"
@@ -579,7 +580,7 @@ function tpt.set_property(prop, value, ...)
 				local ix, iy = sim.partPosition(i)
 				ix = math.floor(ix + 0.5)
 				iy = math.floor(iy + 0.5)
-				if ix >= x and iy >= y and ix < x + w and iy < y + h and (not filter or sim.partProperty(i, "type") == filter) then
+				if ix >= x and iy >= y and ix < x + w and iy < y + h and (not filter or sim.partProperty(i, sim.FIELD_TYPE) == filter) then
 					sim.partProperty(i, prop, value)
 				end
 			end
@@ -590,19 +591,19 @@ function tpt.set_property(prop, value, ...)
 	local i
 	if type(y) == "number" then
 		i = sim.pmap(x, y)
-		if i and filter and sim.partProperty(i, "type") ~= filter then
+		if i and filter and sim.partProperty(i, sim.FIELD_TYPE) ~= filter then
 			i = nil
 		end
 		if not i then
 			i = sim.photons(x, y)
-			if i and filter and sim.partProperty(i, "type") ~= filter then
+			if i and filter and sim.partProperty(i, sim.FIELD_TYPE) ~= filter then
 				i = nil
 			end
 		end
 	else
 		i = x
 	end
-	if i and filter and sim.partProperty(i, "type") ~= filter then
+	if i and filter and sim.partProperty(i, sim.FIELD_TYPE) ~= filter then
 		i = nil
 	end
 	if i then
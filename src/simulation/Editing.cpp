@@ -46,6 +46,7 @@ std::unique_ptr<Snapshot> Simulation::CreateSnapshot() const
 
 void Simulation::Restore(const Snapshot &snap)
 {
+	particleIdGeneration += 1;
 	std::fill(elementCount, elementCount + PT_NUM, 0);
 	elementRecount = true;
 	force_stacking_check = true;
@@ -8,7 +8,14 @@
 #include "Simulation.h"
 #include "SimulationData.h"
 
-SaveRenderer::SaveRenderer()
+#include <algorithm>
+#include <thread>
+
+// Each context takes up about 40MB, so there is no point in having one per core
+// on machines with lots of them.
+constexpr int maxContextsCap = 4;
+
+SaveRenderer::Context::Context()
 {
 	sim = std::make_unique<Simulation>();
 	ren = std::make_unique<Renderer>(sim.get());
@@ -16,14 +23,71 @@ SaveRenderer::SaveRenderer()
 	ren->blackDecorations = true;
 }
 
+SaveRenderer::Context::~Context() = default;
+
+SaveRenderer::SaveRenderer()
+{
+	maxContexts = std::clamp(int(std::thread::hardware_concurrency()), 1, maxContextsCap);
+	// The rest are created when they are first needed
+	idleContexts.push_back(std::make_unique<Context>());
+	contextCount = 1;
+}
+
 SaveRenderer::~SaveRenderer() = default;
 
+std::unique_ptr<SaveRenderer::Context> SaveRenderer::AcquireContext()
+{
+	{
+		std::unique_lock lk(poolMutex);
+		if (idleContexts.empty() && contextCount < maxContexts)
+		{
+			contextCount += 1;
+		}
+		else
+		{
+			poolCv.wait(lk, [this]() {
+				return !idleContexts.empty();
+			});
+			auto context = std::move(idleContexts.back());
+			idleContexts.pop_back();
+			return context;
+		}
+	}
+	try
+	{
+		return std::make_unique<Context>();
+	}
+	catch (...)
+	{
+		std::lock_guard lk(poolMutex);
+		contextCount -= 1;
+		throw;
+	}
+}
+
+void SaveRenderer::ReleaseContext(std::unique_ptr<Context> context)
+{
+	{
+		std::lock_guard lk(poolMutex);
+		idleContexts.push_back(std::move(context));
+	}
+	poolCv.notify_one();
+}
+
 std::unique_ptr<VideoBuffer> SaveRenderer::Render(const GameSave *save, bool decorations, bool fire, Renderer *renderModeSource)
 {
+	// acquire the context first so that threads waiting for one do not hold up writers of element info
+	auto context = AcquireContext();
+	auto release = [this](Context *context) {
+		ReleaseContext(std::unique_ptr<Context>(context));
+	};
+	std::unique_ptr<Context, decltype(release)> contextGuard(context.release(), release);
+	auto *sim = contextGuard->sim.get();
+	auto *ren = contextGuard->ren.get();
+
 	// this function usually runs on a thread different from where element info in SimulationData may be written, so we acquire a read-only lock on it
 	auto &sd = SimulationData::CRef();
 	std::shared_lock lk(sd.elementGraphicsMx);
-	std::lock_guard<std::mutex> gx(renderMutex);
 
 	ren->ResetModes();
 	if (renderModeSource)
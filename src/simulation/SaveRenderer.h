@@ -1,4 +1,5 @@
 #pragma once
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <utility>
@@ -13,12 +14,33 @@ class Renderer;
 
 class SaveRenderer: public ExplicitSingleton<SaveRenderer>
 {
-	std::unique_ptr<Simulation> sim;
-	std::unique_ptr<Renderer> ren;
-	std::mutex renderMutex;
+	// A Simulation and Renderer pair that renders one save at a time. Several of
+	// these are kept around so that saves can be rendered in parallel.
+	struct Context
+	{
+		std::unique_ptr<Simulation> sim;
+		std::unique_ptr<Renderer> ren;
+
+		Context();
+		~Context();
+	};
+
+	std::vector<std::unique_ptr<Context>> idleContexts;
+	int contextCount = 0;
+	int maxContexts;
+	std::mutex poolMutex;
+	std::condition_variable poolCv;
+
+	std::unique_ptr<Context> AcquireContext();
+	void ReleaseContext(std::unique_ptr<Context> context);
 
 public:
 	SaveRenderer();
 	~SaveRenderer();
 	std::unique_ptr<VideoBuffer> Render(const GameSave *save, bool decorations = true, bool fire = true, Renderer *renderModeSource = nullptr);
+
+	int MaxContexts() const
+	{
+		return maxContexts;
+	}
 };
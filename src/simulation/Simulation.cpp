@@ -28,6 +28,7 @@ void Simulation::Load(const GameSave *save, bool includePressure, Vec2<int> bloc
 	auto &sd = SimulationData::CRef();
 	auto &elements = sd.elements;
 
+	particleIdGeneration += 1;
 	RecalcFreeParticles(false);
 
 	struct ExistingParticle
@@ -1042,6 +1043,7 @@ int Simulation::parts_avg(int ci, int ni,int t)
 
 void Simulation::clear_sim(void)
 {
+	particleIdGeneration += 1;
 	ensureDeterminism = false;
 	frameCount = 0;
 	debug_nextToUpdate = 0;
@@ -2345,6 +2347,11 @@ void Simulation::UpdateUpTo(int upTo)
 void Simulation::UpdateParticles(int start, int end)
 {
 	debug_interestingChangeOccurred = false;
+	debug_updateEnd = end;
+	if (start == 0)
+	{
+		updateLoopCount += 1;
+	}
 
 	//the main particle loop function, goes over all particles.
 	auto &sd = SimulationData::CRef();
@@ -3612,6 +3619,7 @@ void Simulation::FixSoapLinks(std::map<unsigned int, unsigned int> &soapList)
 void Simulation::ReloadParticleOrder()
 {
 	CompleteDebugUpdateParticles();
+	particleIdGeneration += 1;
 	// use pmap_count as count buffer
 	memset(pmap_count, 0, sizeof(pmap_count));
 	memset(stackReorderParts, 0, sizeof(stackReorderParts));
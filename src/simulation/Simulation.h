@@ -65,6 +65,9 @@ public:
 
 	int debug_nextToUpdate;
 	int debug_mostRecentlyUpdated = -1; // -1 when between full update loops
+	int debug_updateEnd = NPART; // end of the range being updated by UpdateParticles
+	uint64_t updateLoopCount = 0; // full update loops started, never reset
+	uint64_t particleIdGeneration = 0; // bumped whenever particle IDs may be reassigned
 	bool debug_interestingChangeOccurred;
 	bool needReloadParticleOrder;
 	int parts_lastActiveIndex;
@@ -1,14 +1,30 @@
 #include "AbandonableTask.h"
+#include "TaskScheduler.h"
 
 void AbandonableTask::doWork_wrapper()
 {
-	Task::doWork_wrapper();
-	done_cv.notify_one();
+	bool abandonedEarly;
+	{
+		std::lock_guard<std::mutex> g(taskMutex);
+		abandonedEarly = thAbandoned;
+	}
+	if (abandonedEarly)
+	{
+		// Abandoned just as a worker picked it up, no point in doing the work
+		delete this;
+		return;
+	}
 
+	bool newSuccess = doWork();
 	bool abandoned;
 	{
+		// Everything is done while holding the mutex, as Finish may delete the
+		// task as soon as it sees thDone
 		std::lock_guard<std::mutex> g(taskMutex);
+		thSuccess = newSuccess;
+		thDone = true;
 		abandoned = thAbandoned;
+		done_cv.notify_one();
 	}
 	if (abandoned)
 	{
@@ -34,6 +50,13 @@ void AbandonableTask::Finish()
 
 void AbandonableTask::Abandon()
 {
+	// If no worker has picked it up yet, it is simply never run
+	if (TaskScheduler::Ref().Cancel(this))
+	{
+		delete this;
+		return;
+	}
+
 	bool delete_this = false;
 	{
 		std::lock_guard<std::mutex> g(taskMutex);
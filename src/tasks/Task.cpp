@@ -1,6 +1,7 @@
 #include "Task.h"
 
 #include "TaskListener.h"
+#include "TaskScheduler.h"
 
 void Task::AddTaskListener(TaskListener * listener)
 {
@@ -12,7 +13,15 @@ void Task::AddTaskListener(TaskListener * listener)
 void Task::Start()
 {
 	before();
-	std::thread([this]() { doWork_wrapper(); }).detach();
+	TaskScheduler::Ref().Schedule(this);
+}
+
+void Task::SetPriority(Priority newPriority)
+{
+	if (priority != newPriority)
+	{
+		TaskScheduler::Ref().SetPriority(this, newPriority);
+	}
 }
 
 int Task::GetProgress()
@@ -1,13 +1,26 @@
 #pragma once
 #include "common/String.h"
+#include <cstdint>
 #include <thread>
 #include <mutex>
 
 class TaskListener;
+class TaskScheduler;
 class Task {
 public:
+	// Tasks of higher priority are picked up by TaskScheduler first.
+	enum Priority
+	{
+		priorityPrefetch,
+		priorityOffscreen,
+		priorityVisible,
+		priorityUser, // default, for tasks the user is waiting on
+	};
+
 	void AddTaskListener(TaskListener * listener);
 	virtual void Start();
+	// Can be changed until the task is picked up by a worker.
+	void SetPriority(Priority newPriority);
 	int GetProgress();
 	bool GetDone();
 	bool GetSuccess();
@@ -33,6 +46,12 @@ protected:
 	TaskListener *listener;
 	std::mutex taskMutex;
 
+	// Only accessed by TaskScheduler once the task is started
+	Priority priority = priorityUser;
+	uint64_t serial = 0;
+	bool queued = false;
+	friend class TaskScheduler;
+
 	virtual void before();
 	virtual void after();
 	virtual bool doWork();
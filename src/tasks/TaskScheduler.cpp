@@ -0,0 +1,85 @@
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <thread>
+
+// Some tasks spend most of their time waiting for the network or the disk, so
+// there are at least two workers even on single-core machines.
+constexpr int minWorkers = 2;
+constexpr int maxWorkers = 8;
+
+TaskScheduler::TaskScheduler() : state(std::make_shared<State>())
+{
+	workerCount = std::clamp(int(std::thread::hardware_concurrency()), minWorkers, maxWorkers);
+	for (int i = 0; i < workerCount; i++)
+	{
+		std::thread(Worker, state).detach();
+	}
+}
+
+TaskScheduler::~TaskScheduler()
+{
+	{
+		std::lock_guard lk(state->mx);
+		state->stop = true;
+		state->queue.clear();
+	}
+	state->cv.notify_all();
+}
+
+void TaskScheduler::Worker(std::shared_ptr<State> state)
+{
+	while (true)
+	{
+		Task *task;
+		{
+			std::unique_lock lk(state->mx);
+			state->cv.wait(lk, [&state]() {
+				return state->stop || !state->queue.empty();
+			});
+			if (state->stop)
+			{
+				break;
+			}
+			auto it = state->queue.begin();
+			task = it->task;
+			task->queued = false;
+			state->queue.erase(it);
+		}
+		// AbandonableTasks may delete themselves in here, task is not to be used afterwards
+		task->doWork_wrapper();
+	}
+}
+
+void TaskScheduler::Schedule(Task *task)
+{
+	{
+		std::lock_guard lk(state->mx);
+		task->serial = state->nextSerial++;
+		task->queued = true;
+		state->queue.insert({ task->priority, task->serial, task });
+	}
+	state->cv.notify_one();
+}
+
+bool TaskScheduler::Cancel(Task *task)
+{
+	std::lock_guard lk(state->mx);
+	if (!task->queued)
+	{
+		return false;
+	}
+	state->queue.erase({ task->priority, task->serial, task });
+	task->queued = false;
+	return true;
+}
+
+void TaskScheduler::SetPriority(Task *task, Task::Priority priority)
+{
+	std::lock_guard lk(state->mx);
+	if (task->queued)
+	{
+		state->queue.erase({ task->priority, task->serial, task });
+		state->queue.insert({ priority, task->serial, task });
+	}
+	task->priority = priority;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "common/ExplicitSingleton.h"
+#include "Task.h"
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+
+// Runs started Tasks on a fixed number of worker threads, higher priorities
+// first and in the order in which they were started otherwise.
+class TaskScheduler : public ExplicitSingleton<TaskScheduler>
+{
+	struct Entry
+	{
+		Task::Priority priority;
+		uint64_t serial;
+		Task *task;
+
+		bool operator <(const Entry &other) const
+		{
+			if (priority != other.priority)
+			{
+				return priority > other.priority;
+			}
+			return serial < other.serial;
+		}
+	};
+
+	struct State
+	{
+		std::mutex mx;
+		std::condition_variable cv;
+		std::set<Entry> queue;
+		uint64_t nextSerial = 0;
+		bool stop = false;
+	};
+	// Shared with the workers, which are not waited for when the scheduler is
+	// destroyed, as they may be stuck in a task that takes a long time to finish.
+	std::shared_ptr<State> state;
+	int workerCount;
+
+	static void Worker(std::shared_ptr<State> state);
+
+public:
+	TaskScheduler();
+	~TaskScheduler();
+
+	void Schedule(Task *task);
+	// Returns true if the task had not been picked up by a worker yet,
+	// in which case it never will be.
+	bool Cancel(Task *task);
+	void SetPriority(Task *task, Task::Priority priority);
+
+	int WorkerCount() const
+	{
+		return workerCount;
+	}
+};
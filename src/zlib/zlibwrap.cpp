@@ -0,0 +1,126 @@
+#include "zlibwrap.h"
+#include <zlib.h>
+#include <memory>
+#include <functional>
+#include <vector>
+#include <algorithm>
+
+static size_t outputSizeIncrement = 0x100000U;
+
+ZlibWCompressResult ZlibWCompress(std::vector<char> &dest, const char *srcData, size_t srcSize, size_t maxSize)
+{
+	z_stream stream;
+	stream.zalloc = Z_NULL;
+	stream.zfree = Z_NULL;
+	stream.opaque = Z_NULL;
+	// Favour speed; these are only ever used for data that stays on this machine
+	if (deflateInit(&stream, Z_BEST_SPEED) != Z_OK)
+	{
+		return ZlibWCompressNomem;
+	}
+	std::unique_ptr<z_stream, std::function<int (z_stream *)>> zlibData(&stream, deflateEnd);
+	stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(srcData));
+	stream.avail_in = uInt(srcSize);
+	dest.resize(0);
+	bool done = false;
+	while (!done)
+	{
+		size_t oldSize = dest.size();
+		size_t newSize = oldSize + std::max(outputSizeIncrement, size_t(deflateBound(&stream, stream.avail_in)));
+		if (maxSize && newSize > maxSize)
+		{
+			newSize = maxSize;
+		}
+		if (oldSize == newSize)
+		{
+			return ZlibWCompressLimit;
+		}
+		try
+		{
+			dest.resize(newSize);
+		}
+		catch (const std::bad_alloc &)
+		{
+			return ZlibWCompressNomem;
+		}
+		stream.next_out = reinterpret_cast<Bytef *>(&dest[stream.total_out]);
+		stream.avail_out = uInt(dest.size() - stream.total_out);
+		if (deflate(&stream, Z_FINISH) == Z_STREAM_END)
+		{
+			done = true;
+		}
+	}
+	dest.resize(stream.total_out);
+	return ZlibWCompressOk;
+}
+
+ZlibWDecompressResult ZlibWDecompress(std::vector<char> &dest, const char *srcData, size_t srcSize, size_t maxSize)
+{
+	z_stream stream;
+	stream.zalloc = Z_NULL;
+	stream.zfree = Z_NULL;
+	stream.opaque = Z_NULL;
+	stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(srcData));
+	stream.avail_in = uInt(srcSize);
+	if (inflateInit(&stream) != Z_OK)
+	{
+		return ZlibWDecompressNomem;
+	}
+	std::unique_ptr<z_stream, std::function<int (z_stream *)>> zlibData(&stream, inflateEnd);
+	dest.resize(0);
+	bool done = false;
+	while (!done)
+	{
+		size_t oldSize = dest.size();
+		size_t newSize = oldSize + outputSizeIncrement;
+		if (maxSize && newSize > maxSize)
+		{
+			newSize = maxSize;
+		}
+		if (oldSize == newSize)
+		{
+			return ZlibWDecompressLimit;
+		}
+		try
+		{
+			dest.resize(newSize);
+		}
+		catch (const std::bad_alloc &)
+		{
+			return ZlibWDecompressNomem;
+		}
+		stream.next_out = reinterpret_cast<Bytef *>(&dest[stream.total_out]);
+		stream.avail_out = uInt(dest.size() - stream.total_out);
+		switch (inflate(&stream, Z_NO_FLUSH))
+		{
+		case Z_OK:
+			if (!stream.avail_in && stream.avail_out)
+			{
+				return ZlibWDecompressEof;
+			}
+			break;
+
+		case Z_BUF_ERROR:
+			// No progress possible: either out of input or out of output space
+			if (!stream.avail_in)
+			{
+				return ZlibWDecompressEof;
+			}
+			break;
+
+		case Z_MEM_ERROR:
+			return ZlibWDecompressNomem;
+
+		case Z_NEED_DICT:
+		case Z_DATA_ERROR:
+		case Z_STREAM_ERROR:
+			return ZlibWDecompressBad;
+
+		case Z_STREAM_END:
+			done = true;
+			break;
+		}
+	}
+	dest.resize(stream.total_out);
+	return ZlibWDecompressOk;
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+enum ZlibWCompressResult
+{
+	ZlibWCompressOk,
+	ZlibWCompressNomem,
+	ZlibWCompressLimit,
+};
+ZlibWCompressResult ZlibWCompress(std::vector<char> &dest, const char *srcData, size_t srcSize, size_t maxSize = 0);
+
+enum ZlibWDecompressResult
+{
+	ZlibWDecompressOk,
+	ZlibWDecompressNomem,
+	ZlibWDecompressLimit,
+	ZlibWDecompressBad,
+	ZlibWDecompressEof,
+};
+ZlibWDecompressResult ZlibWDecompress(std::vector<char> &dest, const char *srcData, size_t srcSize, size_t maxSize = 0);